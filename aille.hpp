@@ -33,6 +33,17 @@
 #include <ctime>
 #include <functional>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#ifdef AILLE_ENABLE_TRACING
+#include <atomic>
+#include <mutex>
+#endif
+
 namespace AILLE {
 
 // ============================================================================
@@ -45,6 +56,7 @@ struct AuditRecord;
 struct AILLEConfig;
 class AILLEEngine;
 class AuditLogger;
+class DecisionObserver;
 
 enum DecisionStatus {
     DECISION_VALID,
@@ -54,6 +66,14 @@ enum DecisionStatus {
     ERROR_NO_MODELS
 };
 
+// Per-model result of one decision, reported to DecisionObserver
+enum ModelOutcome {
+    MODEL_PASSED,        // Confidence at or above min_confidence_threshold
+    MODEL_GRACE,         // Admitted in the grace band with confidence x0.8
+    MODEL_REJECTED,      // Below grace_confidence_threshold
+    MODEL_DISAGREED      // Admitted, but sign differs from the consensus median
+};
+
 // ============================================================================
 // DATA STRUCTURES
 // ============================================================================
@@ -81,11 +101,17 @@ struct Decision {
     int models_agreed;
     bool fallback_used;
     uint64_t timestamp_ns;
+    uint64_t latency_ns;       // makeDecision() duration; 0 unless an observer is attached
     std::vector<int> contributing_models;
     std::string reasoning;
     
     Decision() : final_value(0.0f), status(ERROR_NO_MODELS), confidence(0.0f),
-                 models_agreed(0), fallback_used(false), timestamp_ns(0) {}
+                 models_agreed(0), fallback_used(false), timestamp_ns(0), latency_ns(0) {}
+};
+
+struct ModelOutcomeReport {
+    int model_id;
+    ModelOutcome outcome;
 };
 
 struct AILLEConfig {
@@ -107,6 +133,302 @@ struct AILLEConfig {
         max_model_count(10) {}
 };
 
+// ============================================================================
+// DECISION OBSERVER (OPTIONAL - Timing compiles out with -DAILLE_DISABLE_TIMING)
+// ============================================================================
+
+// Receives per-decision measurements from AILLEEngine::setObserver().
+// Called synchronously on the deciding thread; keep implementations cheap.
+class DecisionObserver {
+public:
+    virtual ~DecisionObserver() {}
+
+    // Duration of one makeDecision() call, by outcome
+    virtual void onDecisionLatency(DecisionStatus status, uint64_t latency_ns) {
+        (void)status;
+        (void)latency_ns;
+    }
+
+    // Safety-layer result for every input signal (PASSED/GRACE/REJECTED),
+    // plus DISAGREED for admitted signals against the consensus median
+    virtual void onModelOutcome(int model_id, ModelOutcome outcome) {
+        (void)model_id;
+        (void)outcome;
+    }
+
+    // All outcomes of one decision in a single call, after makeDecision()
+    // finishes. The default forwards each to onModelOutcome().
+    virtual void onModelOutcomes(const ModelOutcomeReport* reports, size_t count) {
+        for (size_t i = 0; i < count; ++i) onModelOutcome(reports[i].model_id, reports[i].outcome);
+    }
+
+    // Raw input signals of each non-empty makeDecision() call, delivered
+    // after the decision is made and timed
+    virtual void onSignals(const std::vector<ModelSignal>& signals) {
+        (void)signals;
+    }
+};
+
+// Forwards every report to several observers, in order (not owned)
+class ObserverFanout : public DecisionObserver {
+private:
+    std::vector<DecisionObserver*> observers;
+
+public:
+    void add(DecisionObserver* obs) {
+        if (obs) observers.push_back(obs);
+    }
+
+    void onDecisionLatency(DecisionStatus status, uint64_t latency_ns) override {
+        for (DecisionObserver* o : observers) o->onDecisionLatency(status, latency_ns);
+    }
+
+    void onModelOutcome(int model_id, ModelOutcome outcome) override {
+        for (DecisionObserver* o : observers) o->onModelOutcome(model_id, outcome);
+    }
+
+    void onModelOutcomes(const ModelOutcomeReport* reports, size_t count) override {
+        for (DecisionObserver* o : observers) o->onModelOutcomes(reports, count);
+    }
+
+    void onSignals(const std::vector<ModelSignal>& signals) override {
+        for (DecisionObserver* o : observers) o->onSignals(signals);
+    }
+};
+
+// Cheap tick source: TSC on x86, the virtual counter on AArch64,
+// steady_clock elsewhere. TSC ticks are converted with a ratio calibrated
+// once against steady_clock (assumes an invariant TSC, as on all current
+// x86-64 server parts).
+struct CycleClock {
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static double nsPerTick() {
+        static const double ratio = calibrate();
+        return ratio;
+    }
+
+    static uint64_t toNs(uint64_t ticks) {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick());
+    }
+
+private:
+    static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = now();
+        while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(2)) {}
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t c1 = now();
+        double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        return c1 > c0 ? ns / static_cast<double>(c1 - c0) : 1.0;
+#elif defined(__aarch64__)
+        uint64_t freq;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+        return freq ? 1e9 / static_cast<double>(freq) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+// ============================================================================
+// STAGE TRACING (OPTIONAL - Compile in with -DAILLE_ENABLE_TRACING)
+// ============================================================================
+
+#ifdef AILLE_ENABLE_TRACING
+
+enum TraceStage {
+    TRACE_SAFETY_LAYER,
+    TRACE_CONSENSUS,
+    TRACE_FALLBACK_VALUE,
+    TRACE_SMOOTH_POSITION,
+    TRACE_FALLBACK_UPDATE,
+    TRACE_STAGE_COUNT
+};
+
+inline const char* traceStageName(int stage) {
+    switch (stage) {
+        case TRACE_SAFETY_LAYER: return "applySafetyLayer";
+        case TRACE_CONSENSUS: return "checkConsensus";
+        case TRACE_FALLBACK_VALUE: return "getFallbackValue";
+        case TRACE_SMOOTH_POSITION: return "smoothPosition";
+        case TRACE_FALLBACK_UPDATE: return "updateFallbackBuffer";
+        default: return "unknown";
+    }
+}
+
+// Aggregated stage timings; histogram bucket b holds [2^b, 2^(b+1)) cycles
+struct StageTraceSummary {
+    static constexpr int CYCLE_BUCKETS = 40;
+
+    uint64_t count[TRACE_STAGE_COUNT] = {};
+    uint64_t cycles[TRACE_STAGE_COUNT] = {};
+    uint64_t histogram[TRACE_STAGE_COUNT][CYCLE_BUCKETS] = {};
+
+    double meanCycles(int stage) const {
+        return count[stage] ? static_cast<double>(cycles[stage]) / count[stage] : 0.0;
+    }
+    double meanNs(int stage) const { return meanCycles(stage) * CycleClock::nsPerTick(); }
+
+    // Upper bound of the bucket holding the pct-th percentile (0-100)
+    uint64_t percentileCycles(int stage, double pct) const {
+        if (count[stage] == 0) return 0;
+        double target = pct / 100.0 * static_cast<double>(count[stage]);
+        uint64_t cumulative = 0;
+        for (int b = 0; b < CYCLE_BUCKETS; ++b) {
+            cumulative += histogram[stage][b];
+            if (static_cast<double>(cumulative) >= target) return (uint64_t(2) << b) - 1;
+        }
+        return (uint64_t(2) << (CYCLE_BUCKETS - 1)) - 1;
+    }
+};
+
+// One per thread, written only by its owner. Relaxed load/add/store keeps
+// the hot path free of locked instructions while letting collect() read
+// from other threads.
+struct StageTrace {
+    std::atomic<uint64_t> count[TRACE_STAGE_COUNT] = {};
+    std::atomic<uint64_t> cycles[TRACE_STAGE_COUNT] = {};
+    std::atomic<uint64_t> histogram[TRACE_STAGE_COUNT][StageTraceSummary::CYCLE_BUCKETS] = {};
+
+    void record(int stage, uint64_t ticks) {
+        int bucket = 0;
+        for (uint64_t t = ticks >> 1; t != 0 && bucket < StageTraceSummary::CYCLE_BUCKETS - 1;
+             t >>= 1) {
+            ++bucket;
+        }
+        bump(count[stage], 1);
+        bump(cycles[stage], ticks);
+        bump(histogram[stage][bucket], 1);
+    }
+
+    void addTo(StageTraceSummary& out) const {
+        for (int s = 0; s < TRACE_STAGE_COUNT; ++s) {
+            out.count[s] += count[s].load(std::memory_order_relaxed);
+            out.cycles[s] += cycles[s].load(std::memory_order_relaxed);
+            for (int b = 0; b < StageTraceSummary::CYCLE_BUCKETS; ++b) {
+                out.histogram[s][b] += histogram[s][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void clear() {
+        for (int s = 0; s < TRACE_STAGE_COUNT; ++s) {
+            count[s].store(0, std::memory_order_relaxed);
+            cycles[s].store(0, std::memory_order_relaxed);
+            for (auto& b : histogram[s]) b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& a, uint64_t v) {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+};
+
+class StageTracer {
+public:
+    // The calling thread's trace (registered on first use)
+    static StageTrace& local() {
+        thread_local Slot slot;
+        return slot.trace;
+    }
+
+    // Sum over live threads plus threads that have exited
+    static StageTraceSummary collect() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        StageTraceSummary out = r.retired;
+        for (const StageTrace* t : r.live) t->addTo(out);
+        return out;
+    }
+
+    // Racy against concurrent decisions; intended between measurement runs
+    static void reset() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        r.retired = StageTraceSummary();
+        for (StageTrace* t : r.live) t->clear();
+    }
+
+private:
+    struct Registry {
+        std::mutex mtx;
+        std::vector<StageTrace*> live;
+        StageTraceSummary retired;
+    };
+
+    static Registry& registry() {
+        static Registry r;
+        return r;
+    }
+
+    struct Slot {
+        StageTrace trace;
+
+        Slot() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mtx);
+            r.live.push_back(&trace);
+        }
+
+        ~Slot() {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mtx);
+            trace.addTo(r.retired);
+            r.live.erase(std::remove(r.live.begin(), r.live.end(), &trace), r.live.end());
+        }
+    };
+};
+
+// Times the enclosing scope (TSC ticks, not serialized: stage boundaries
+// may shift by a few dozen cycles under out-of-order execution)
+class StageTraceScope {
+private:
+    int stage;
+    uint64_t start;
+
+public:
+    explicit StageTraceScope(int s) : stage(s), start(CycleClock::now()) {}
+    ~StageTraceScope() { StageTracer::local().record(stage, CycleClock::now() - start); }
+};
+
+#define AILLE_TRACE_STAGE(stage) ::AILLE::StageTraceScope aille_trace_scope_(stage)
+
+inline std::string formatStageTraces(const StageTraceSummary& t) {
+    std::ostringstream out;
+    out << std::left << std::setw(22) << "Stage" << std::right
+        << std::setw(12) << "Calls" << std::setw(12) << "Mean ns"
+        << std::setw(14) << "p50 cycles" << std::setw(14) << "p99 cycles" << "\n";
+    for (int s = 0; s < TRACE_STAGE_COUNT; ++s) {
+        out << std::left << std::setw(22) << traceStageName(s) << std::right
+            << std::setw(12) << t.count[s]
+            << std::setw(12) << std::fixed << std::setprecision(1) << t.meanNs(s)
+            << std::setw(14) << "<=" + std::to_string(t.percentileCycles(s, 50.0))
+            << std::setw(14) << "<=" + std::to_string(t.percentileCycles(s, 99.0)) << "\n";
+    }
+    return out.str();
+}
+
+#else
+
+#define AILLE_TRACE_STAGE(stage) ((void)0)
+
+#endif // AILLE_ENABLE_TRACING
+
 // ============================================================================
 // AILLE ENGINE
 // ============================================================================
@@ -115,6 +437,8 @@ class AILLEEngine {
 private:
     AILLEConfig config;
     std::deque<float> fallback_buffer;
+    DecisionObserver* observer = nullptr;
+    std::vector<ModelOutcomeReport> outcomes;   // reported once per decision
     
     float calculateFallbackValue() const {
         if (fallback_buffer.empty()) return 0.0f;
@@ -124,6 +448,7 @@ private:
     }
     
     void updateFallbackBuffer(float value) {
+        AILLE_TRACE_STAGE(TRACE_FALLBACK_UPDATE);
         fallback_buffer.push_back(value);
         while (fallback_buffer.size() > static_cast<size_t>(config.fallback_window_size)) {
             fallback_buffer.pop_front();
@@ -131,18 +456,24 @@ private:
     }
     
     float smoothPosition(float signal, float scale = 100.0f) const {
+        AILLE_TRACE_STAGE(TRACE_SMOOTH_POSITION);
         return std::tanh(signal * scale);
     }
     
     std::vector<ModelSignal> applySafetyLayer(const std::vector<ModelSignal>& signals) {
+        AILLE_TRACE_STAGE(TRACE_SAFETY_LAYER);
         std::vector<ModelSignal> valid;
         for (const auto& sig : signals) {
             if (sig.confidence >= config.min_confidence_threshold) {
                 valid.push_back(sig);
+                if (observer) outcomes.push_back({sig.model_id, MODEL_PASSED});
             } else if (sig.confidence >= config.grace_confidence_threshold) {
                 ModelSignal grace_sig = sig;
                 grace_sig.confidence *= 0.8f;
                 valid.push_back(grace_sig);
+                if (observer) outcomes.push_back({sig.model_id, MODEL_GRACE});
+            } else if (observer) {
+                outcomes.push_back({sig.model_id, MODEL_REJECTED});
             }
         }
         return valid;
@@ -150,6 +481,7 @@ private:
     
     bool checkConsensus(const std::vector<ModelSignal>& valid_signals,
                        float& consensus_value, int& models_agreed) {
+        AILLE_TRACE_STAGE(TRACE_CONSENSUS);
         if (valid_signals.size() < static_cast<size_t>(config.min_models_required)) {
             models_agreed = 0;
             return false;
@@ -167,6 +499,13 @@ private:
         for (float val : values) {
             if (((val >= 0) ? 1.0f : -1.0f) == median_sign) agreement_count++;
         }
+        if (observer) {
+            for (const auto& sig : valid_signals) {
+                if (((sig.value >= 0) ? 1.0f : -1.0f) != median_sign) {
+                    outcomes.push_back({sig.model_id, MODEL_DISAGREED});
+                }
+            }
+        }
         
         models_agreed = agreement_count;
         float agreement_ratio = static_cast<float>(agreement_count) / values.size();
@@ -188,6 +527,7 @@ private:
     }
     
     float getFallbackValue() const {
+        AILLE_TRACE_STAGE(TRACE_FALLBACK_VALUE);
         float fb = calculateFallbackValue();
         return ((fb >= 0) ? 1.0f : -1.0f) * config.fallback_position_scale;
     }
@@ -197,6 +537,40 @@ public:
     explicit AILLEEngine(const AILLEConfig& cfg) : config(cfg) {}
     
     Decision makeDecision(const std::vector<ModelSignal>& model_signals) {
+        if (!observer) return makeDecisionImpl(model_signals);
+#ifndef AILLE_DISABLE_TIMING
+        uint64_t start = CycleClock::now();
+#endif
+        Decision decision = makeDecisionImpl(model_signals);
+#ifndef AILLE_DISABLE_TIMING
+        decision.latency_ns = CycleClock::toNs(CycleClock::now() - start);
+        observer->onDecisionLatency(decision.status, decision.latency_ns);
+#endif
+        // Observer work stays outside the timed window
+        if (!model_signals.empty()) observer->onSignals(model_signals);
+        if (!outcomes.empty()) {
+            observer->onModelOutcomes(outcomes.data(), outcomes.size());
+            outcomes.clear();
+        }
+        return decision;
+    }
+    
+    // Optional observer (not owned; nullptr detaches). Latency reports are
+    // compiled out with AILLE_DISABLE_TIMING; model outcomes are not.
+    void setObserver(DecisionObserver* obs) {
+#ifndef AILLE_DISABLE_TIMING
+        if (obs) CycleClock::nsPerTick();  // calibrate off the hot path
+#endif
+        outcomes.clear();
+        observer = obs;
+    }
+    
+    void reset() { fallback_buffer.clear(); }
+    AILLEConfig getConfig() const { return config; }
+    void setConfig(const AILLEConfig& cfg) { config = cfg; }
+
+private:
+    Decision makeDecisionImpl(const std::vector<ModelSignal>& model_signals) {
         Decision decision;
         decision.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()
@@ -249,10 +623,6 @@ public:
         updateFallbackBuffer(decision.final_value);
         return decision;
     }
-    
-    void reset() { fallback_buffer.clear(); }
-    AILLEConfig getConfig() const { return config; }
-    void setConfig(const AILLEConfig& cfg) { config = cfg; }
 };
 
 // ============================================================================
@@ -0,0 +1,256 @@
+/*
+ * AILLE Microbenchmarks
+ *
+ * Per-operation cost of the decision path and of the optional layers
+ * around it:
+ *
+ *   make_decision   full makeDecision() by model count and scenario
+ *   audit           AuditLogger::logDecision(), in memory and to a file
+ *   metrics         MetricsCollector::observeDecision() per policy
+ *
+ * Model counts run from 1 to 1024. Inputs are generated up front with a
+ * fixed seed and cycled, so branch patterns vary but runs are repeatable.
+ *
+ * Built with -DAILLE_ENABLE_TRACING (make bench-stages), each
+ * make_decision run is also broken down by stage (safety layer,
+ * consensus, fallback value / buffer update, position smoothing) from
+ * the StageTracer counters. Stage times then include the tracepoints'
+ * own cost, so compare them with each other rather than with the
+ * untraced make_decision numbers.
+ *
+ * Usage: aille-bench [--filter SUBSTR[,SUBSTR...]] [--min-time-ms N] [--reps N]
+ *                    [--json PATH] [--list]
+ */
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "bench/bench_harness.hpp"
+
+namespace {
+
+using AILLE::AILLEEngine;
+using AILLE::ModelSignal;
+using AILLE::bench::BenchRunner;
+using AILLE::bench::doNotOptimize;
+
+const int MODEL_COUNTS[] = {1, 4, 16, 64, 256, 1024};
+const size_t INPUT_SETS = 64;          // distinct inputs cycled per benchmark
+
+// Confidence mixes relative to the default thresholds (0.35 / 0.25)
+enum ConfidenceMix { CONF_HIGH, CONF_MIXED, CONF_LOW };
+
+// `agree` of the signals share the majority sign
+std::vector<std::vector<ModelSignal>> makeInputs(int models, ConfidenceMix mix, double agree,
+                                                 uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> magnitude(0.001f, 0.05f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<std::vector<ModelSignal>> sets(INPUT_SETS);
+    for (auto& set : sets) {
+        float majority = unit(rng) < 0.5f ? 1.0f : -1.0f;
+        set.reserve(models);
+        for (int i = 0; i < models; ++i) {
+            float sign = unit(rng) < agree ? majority : -majority;
+            float conf;
+            switch (mix) {
+                case CONF_HIGH:  conf = 0.6f + 0.35f * unit(rng); break;
+                case CONF_MIXED: conf = 0.1f + 0.85f * unit(rng); break;
+                default:         conf = 0.2f * unit(rng);         break;
+            }
+            set.emplace_back(sign * magnitude(rng), conf, i);
+        }
+    }
+    return sets;
+}
+
+std::string label(const char* group, int models, const char* what) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%s/models=%d/%s", group, models, what);
+    return buf;
+}
+
+struct Scenario {
+    const char* name;
+    ConfidenceMix mix;
+    double agree;
+};
+
+const Scenario SCENARIOS[] = {
+    {"valid", CONF_HIGH, 1.0},         // every signal passes, full agreement
+    {"mixed", CONF_MIXED, 0.8},        // grace band and rejections, some dissent
+    {"no_consensus", CONF_HIGH, 0.5},  // consensus fails -> fallback
+    {"low_confidence", CONF_LOW, 1.0}, // safety layer rejects all -> fallback
+};
+
+#ifdef AILLE_ENABLE_TRACING
+// Stage counters accumulated over one benchmark (calibration included)
+struct StageBreakdown {
+    std::string name;
+    AILLE::StageTraceSummary trace;
+};
+std::vector<StageBreakdown> stage_breakdowns;
+
+void printStageBreakdowns() {
+    if (stage_breakdowns.empty()) return;
+    std::printf("\nPer-stage mean ns (calls per decision) inside makeDecision()\n\n");
+    std::printf("%-40s", "benchmark");
+    for (int s = 0; s < AILLE::TRACE_STAGE_COUNT; ++s) {
+        std::printf(" %22s", AILLE::traceStageName(s));
+    }
+    std::printf("\n%s\n", std::string(40 + 23 * AILLE::TRACE_STAGE_COUNT, '-').c_str());
+    for (const StageBreakdown& b : stage_breakdowns) {
+        // Every non-empty decision runs the safety layer exactly once
+        double decisions = static_cast<double>(b.trace.count[AILLE::TRACE_SAFETY_LAYER]);
+        std::printf("%-40s", b.name.c_str());
+        for (int s = 0; s < AILLE::TRACE_STAGE_COUNT; ++s) {
+            char cell[32] = "-";
+            if (b.trace.count[s] > 0) {
+                std::snprintf(cell, sizeof(cell), "%.1f (%.2f)", b.trace.meanNs(s),
+                              b.trace.count[s] / decisions);
+            }
+            std::printf(" %22s", cell);
+        }
+        std::printf("\n");
+    }
+}
+#endif
+
+void benchMakeDecision(BenchRunner& runner) {
+    for (int models : MODEL_COUNTS) {
+        for (const Scenario& sc : SCENARIOS) {
+            auto inputs = makeInputs(models, sc.mix, sc.agree, 17u * models);
+            AILLEEngine engine;
+            std::string name = label("make_decision", models, sc.name);
+#ifdef AILLE_ENABLE_TRACING
+            AILLE::StageTracer::reset();
+#endif
+            runner.run(name, [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) {
+                    AILLE::Decision d = engine.makeDecision(inputs[i % INPUT_SETS]);
+                    doNotOptimize(d.final_value);
+                }
+            });
+#ifdef AILLE_ENABLE_TRACING
+            if (runner.selected(name) && !runner.getOptions().list_only) {
+                stage_breakdowns.push_back({name, AILLE::StageTracer::collect()});
+            }
+#endif
+        }
+    }
+}
+
+// Decisions as the engine produces them (all statuses, real reasoning text)
+std::vector<AILLE::Decision> makeDecisions() {
+    std::vector<AILLE::Decision> out;
+    AILLEEngine engine;
+    for (const Scenario& sc : SCENARIOS) {
+        for (const auto& set : makeInputs(8, sc.mix, sc.agree, 19u)) {
+            out.push_back(engine.makeDecision(set));
+        }
+    }
+    return out;
+}
+
+void benchAudit(BenchRunner& runner) {
+    auto decisions = makeDecisions();
+
+    // Fresh logger per repetition: the in-memory trail grows without bound
+    std::unique_ptr<AILLE::AuditLogger> logger;
+    runner.run("audit/log_decision/memory",
+               [&](uint64_t n) {
+                   for (uint64_t i = 0; i < n; ++i) {
+                       logger->logDecision(decisions[i % decisions.size()], "BENCH", "bench");
+                   }
+               },
+               [&]() { logger.reset(new AILLE::AuditLogger()); });
+
+    const char* path = "aille_bench_audit.csv";
+    runner.run("audit/log_decision/file",
+               [&](uint64_t n) {
+                   for (uint64_t i = 0; i < n; ++i) {
+                       logger->logDecision(decisions[i % decisions.size()], "BENCH", "bench");
+                   }
+               },
+               [&]() {
+                   logger.reset();
+                   std::remove(path);
+                   logger.reset(new AILLE::AuditLogger(path));
+               });
+    logger.reset();
+    std::remove(path);
+}
+
+template <class Collector>
+void benchCollector(BenchRunner& runner, const char* name, const AILLE::MetricsConfig& cfg,
+                    const std::vector<AILLE::Decision>& decisions) {
+    Collector collector(cfg);
+    runner.run(std::string("metrics/observe_decision/") + name, [&](uint64_t n) {
+        for (uint64_t i = 0; i < n; ++i) {
+            collector.observeDecision(decisions[i % decisions.size()], 800 + (i & 1023));
+            doNotOptimize(collector);   // the null collector has no side effects to keep
+        }
+    });
+}
+
+void benchMetrics(BenchRunner& runner) {
+    auto decisions = makeDecisions();
+    for (auto& d : decisions) d.timestamp_ns = 1000000000ULL;  // stable rolling bucket
+
+    AILLE::MetricsConfig defaults;
+    AILLE::MetricsConfig rolling;
+    rolling.rolling_window_buckets = 3600;
+    AILLE::MetricsConfig sampled;
+    sampled.sample_every = 16;
+    sampled.random_sampling = true;
+
+    benchCollector<AILLE::MetricsCollector>(runner, "full", defaults, decisions);
+    benchCollector<AILLE::MetricsCollector>(runner, "full+rolling", rolling, decisions);
+    benchCollector<AILLE::MetricsCollector>(runner, "full+sample16", sampled, decisions);
+    benchCollector<AILLE::CountersOnlyMetricsCollector>(runner, "counters_only", defaults,
+                                                        decisions);
+    benchCollector<AILLE::NullMetricsCollector>(runner, "null", defaults, decisions);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    AILLE::bench::BenchOptions options;
+    if (!options.parse(argc, argv)) return 2;
+    BenchRunner runner(options);
+
+    if (!options.list_only) {
+        std::printf("AILLE microbenchmarks (median of %d repetitions, >= %.0f ms each)\n\n",
+                    options.repetitions, options.min_time_s * 1e3);
+    }
+
+    benchMakeDecision(runner);
+    benchAudit(runner);
+    benchMetrics(runner);
+#ifdef AILLE_ENABLE_TRACING
+    printStageBreakdowns();
+#endif
+
+    if (!options.json_path.empty() && !options.list_only &&
+        !runner.writeJson(options.json_path)) {
+        std::fprintf(stderr, "cannot write %s\n", options.json_path.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make bench                                  # build and run everything
+ * make bench BENCH_ARGS="--filter audit"      # one group
+ * make bench-stages                           # make_decision by stage
+ * ./aille-bench --list
+ * make bench-compare                          # JSON run + regression check
+ */
@@ -0,0 +1,287 @@
+/*
+ * AILLE Latency Distribution Harness
+ *
+ * Drives makeDecision() open-loop at a fixed target rate, optionally with
+ * an AuditLogger and a MetricsCollector attached the way a deployment
+ * would wire them, and records every decision into a LogLinearHistogram.
+ *
+ * Coordinated omission: a closed loop that waits for each call before
+ * issuing the next one stops sending while a call stalls, so the stall is
+ * recorded once instead of once per request that would have queued behind
+ * it. Here request i is due at start + i / rate regardless of how long
+ * earlier ones took, and its latency is measured from that intended start.
+ * Both distributions are reported:
+ *
+ *   response   completion - intended start (corrected; what callers see)
+ *   service    completion - actual start   (uncorrected; time inside the call)
+ *
+ * A large gap between the two means the target rate is not sustainable.
+ *
+ * Usage: aille-latency [--rate N] [--duration-s S] [--warmup-s S] [--models N]
+ *                      [--audit none|memory|file] [--metrics none|counters|full]
+ *                      [--json PATH|-] [--label TEXT]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_histogram.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "bench/bench_harness.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LatencyOptions {
+    double rate = 20000.0;             // decisions per second
+    double duration_s = 5.0;           // measured phase
+    double warmup_s = 1.0;             // paced but not recorded
+    int models = 8;
+    std::string audit = "none";        // none | memory | file
+    std::string metrics = "none";      // none | counters | full
+    std::string json_path;             // empty: no JSON; "-": stdout
+    std::string label;
+
+    bool parse(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+            if (std::strcmp(arg, "--rate") == 0 && val) {
+                rate = std::atof(val);
+            } else if (std::strcmp(arg, "--duration-s") == 0 && val) {
+                duration_s = std::atof(val);
+            } else if (std::strcmp(arg, "--warmup-s") == 0 && val) {
+                warmup_s = std::atof(val);
+            } else if (std::strcmp(arg, "--models") == 0 && val) {
+                models = std::atoi(val);
+            } else if (std::strcmp(arg, "--audit") == 0 && val) {
+                audit = val;
+            } else if (std::strcmp(arg, "--metrics") == 0 && val) {
+                metrics = val;
+            } else if (std::strcmp(arg, "--json") == 0 && val) {
+                json_path = val;
+            } else if (std::strcmp(arg, "--label") == 0 && val) {
+                label = val;
+            } else {
+                return usage(argv[0]);
+            }
+            ++i;
+        }
+        bool valid = rate > 0.0 && duration_s > 0.0 && warmup_s >= 0.0 && models > 0 &&
+                     (audit == "none" || audit == "memory" || audit == "file") &&
+                     (metrics == "none" || metrics == "counters" || metrics == "full");
+        return valid || usage(argv[0]);
+    }
+
+    static bool usage(const char* prog) {
+        std::fprintf(stderr,
+                     "usage: %s [--rate N] [--duration-s S] [--warmup-s S] [--models N]\n"
+                     "          [--audit none|memory|file] [--metrics none|counters|full]\n"
+                     "          [--json PATH|-] [--label TEXT]\n",
+                     prog);
+        return false;
+    }
+};
+
+// Nanosecond resolution up to 100 s, relative error < 0.1%
+AILLE::HistogramConfig latencyHistogramConfig() {
+    return AILLE::HistogramConfig(1.0, 1e11, 10);
+}
+
+// Mostly valid decisions with a tail of grace-band, no-consensus and
+// low-confidence inputs, cycled from a fixed seed
+std::vector<std::vector<AILLE::ModelSignal>> makeInputs(int models) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<std::vector<AILLE::ModelSignal>> sets(4096);
+    for (auto& set : sets) {
+        float roll = unit(rng);
+        float agree = roll < 0.90f ? 0.95f : 0.5f;
+        float conf_lo = roll < 0.80f ? 0.6f : (roll < 0.95f ? 0.2f : 0.0f);
+        float conf_hi = roll < 0.95f ? 0.95f : 0.2f;
+        float majority = unit(rng) < 0.5f ? 1.0f : -1.0f;
+        for (int m = 0; m < models; ++m) {
+            float sign = unit(rng) < agree ? majority : -majority;
+            float value = sign * (0.001f + 0.049f * unit(rng));
+            float conf = conf_lo + (conf_hi - conf_lo) * unit(rng);
+            set.emplace_back(value, conf, m);
+        }
+    }
+    return sets;
+}
+
+struct RunResult {
+    AILLE::LogLinearHistogram response{latencyHistogramConfig()};
+    AILLE::LogLinearHistogram service{latencyHistogramConfig()};
+    uint64_t decisions = 0;
+    uint64_t late_starts = 0;          // started more than one interval behind schedule
+    double elapsed_s = 0.0;
+};
+
+// Waits until `deadline`: sleeps while far away, spins for the last stretch
+void waitUntil(Clock::time_point deadline) {
+    const auto spin_window = std::chrono::microseconds(100);
+    while (true) {
+        auto now = Clock::now();
+        if (now >= deadline) return;
+        if (deadline - now > spin_window) std::this_thread::sleep_for(deadline - now - spin_window);
+    }
+}
+
+template <class Collector>
+RunResult runPaced(const LatencyOptions& opt, Collector* collector) {
+    auto inputs = makeInputs(opt.models);
+
+    AILLE::AILLEEngine engine;
+    if (collector) engine.setObserver(collector);
+
+    std::unique_ptr<AILLE::AuditLogger> audit;
+    const char* audit_path = "aille_latency_audit.csv";
+    if (opt.audit == "memory") {
+        audit.reset(new AILLE::AuditLogger());
+    } else if (opt.audit == "file") {
+        std::remove(audit_path);
+        audit.reset(new AILLE::AuditLogger(audit_path));
+    }
+
+    const double interval_ns = 1e9 / opt.rate;
+    const uint64_t warmup = static_cast<uint64_t>(opt.warmup_s * opt.rate);
+    const uint64_t total = warmup + static_cast<uint64_t>(opt.duration_s * opt.rate);
+
+    RunResult r;
+    Clock::time_point start = Clock::now();
+    Clock::time_point measured_start = start;
+    volatile float sink = 0.0f;
+
+    for (uint64_t i = 0; i < total; ++i) {
+        auto intended = start + std::chrono::nanoseconds(
+                                    static_cast<int64_t>(static_cast<double>(i) * interval_ns));
+        waitUntil(intended);
+        auto begin = Clock::now();
+
+        AILLE::Decision d = engine.makeDecision(inputs[i % inputs.size()]);
+        if (audit) audit->logDecision(d, "BENCH", "latency");
+        if (collector) collector->observeDecision(d);
+        sink = d.final_value;
+
+        auto end = Clock::now();
+        if (i < warmup) {
+            measured_start = end;
+            continue;
+        }
+        r.response.record(static_cast<double>((end - intended).count()));
+        r.service.record(static_cast<double>((end - begin).count()));
+        if ((begin - intended).count() > interval_ns) ++r.late_starts;
+        ++r.decisions;
+    }
+    r.elapsed_s = std::chrono::duration<double>(Clock::now() - measured_start).count();
+    (void)sink;
+
+    if (opt.audit == "file") {
+        audit.reset();
+        std::remove(audit_path);
+    }
+    return r;
+}
+
+const double PERCENTILES[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+const char* const PERCENTILE_KEYS[] = {"p50", "p90", "p99", "p99_9", "p99_99"};
+
+void printDistribution(const char* name, const AILLE::LogLinearHistogram& h) {
+    std::printf("%-10s %10.0f", name, h.getMean());
+    for (double p : PERCENTILES) std::printf(" %10.0f", h.percentile(p));
+    std::printf(" %12.0f\n", h.getMax());
+}
+
+void writeDistribution(std::FILE* f, const char* name, const AILLE::LogLinearHistogram& h,
+                       bool last) {
+    std::fprintf(f, "    \"%s\": {\"count\": %llu, \"mean\": %.1f, \"min\": %.0f", name,
+                 static_cast<unsigned long long>(h.getTotalCount()), h.getMean(), h.getMin());
+    for (size_t i = 0; i < sizeof(PERCENTILES) / sizeof(PERCENTILES[0]); ++i) {
+        std::fprintf(f, ", \"%s\": %.0f", PERCENTILE_KEYS[i], h.percentile(PERCENTILES[i]));
+    }
+    std::fprintf(f, ", \"max\": %.0f}%s\n", h.getMax(), last ? "" : ",");
+}
+
+bool writeJson(const LatencyOptions& opt, const RunResult& r) {
+    using AILLE::bench::jsonEscape;
+    bool to_stdout = opt.json_path == "-";
+    std::FILE* f = to_stdout ? stdout : std::fopen(opt.json_path.c_str(), "w");
+    if (!f) return false;
+
+    std::fprintf(f, "{\n");
+    std::fprintf(f, "  \"label\": \"%s\",\n", jsonEscape(opt.label).c_str());
+    std::fprintf(f, "  \"config\": {\"rate\": %.1f, \"duration_s\": %.3f, \"warmup_s\": %.3f, "
+                    "\"models\": %d, \"audit\": \"%s\", \"metrics\": \"%s\"},\n",
+                 opt.rate, opt.duration_s, opt.warmup_s, opt.models,
+                 jsonEscape(opt.audit).c_str(), jsonEscape(opt.metrics).c_str());
+    std::fprintf(f, "  \"decisions\": %llu,\n", static_cast<unsigned long long>(r.decisions));
+    std::fprintf(f, "  \"achieved_rate\": %.1f,\n",
+                 r.elapsed_s > 0.0 ? static_cast<double>(r.decisions) / r.elapsed_s : 0.0);
+    std::fprintf(f, "  \"late_starts\": %llu,\n", static_cast<unsigned long long>(r.late_starts));
+    std::fprintf(f, "  \"unit\": \"ns\",\n");
+    std::fprintf(f, "  \"latency\": {\n");
+    writeDistribution(f, "response", r.response, false);
+    writeDistribution(f, "service", r.service, true);
+    std::fprintf(f, "  }\n}\n");
+
+    if (!to_stdout) std::fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LatencyOptions opt;
+    if (!opt.parse(argc, argv)) return 2;
+
+    RunResult r;
+    if (opt.metrics == "full") {
+        AILLE::MetricsCollector collector;
+        r = runPaced(opt, &collector);
+    } else if (opt.metrics == "counters") {
+        AILLE::CountersOnlyMetricsCollector collector;
+        r = runPaced(opt, &collector);
+    } else {
+        r = runPaced<AILLE::MetricsCollector>(opt, nullptr);
+    }
+
+    bool json_stdout = opt.json_path == "-";
+    if (!json_stdout) {
+        double achieved = r.elapsed_s > 0.0 ? static_cast<double>(r.decisions) / r.elapsed_s : 0.0;
+        std::printf("AILLE latency: %.0f/s target, %.0f/s achieved, %llu decisions, "
+                    "models=%d audit=%s metrics=%s\n",
+                    opt.rate, achieved, static_cast<unsigned long long>(r.decisions), opt.models,
+                    opt.audit.c_str(), opt.metrics.c_str());
+        std::printf("late starts (> 1 interval behind schedule): %llu\n\n",
+                    static_cast<unsigned long long>(r.late_starts));
+        std::printf("%-10s %10s %10s %10s %10s %10s %10s %12s\n", "ns", "mean", "p50", "p90",
+                    "p99", "p99.9", "p99.99", "max");
+        printDistribution("response", r.response);
+        printDistribution("service", r.service);
+    }
+
+    if (!opt.json_path.empty() && !writeJson(opt, r)) {
+        std::fprintf(stderr, "cannot write %s\n", opt.json_path.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make latency                                        # 20k/s for 5 s, engine only
+ * make latency LATENCY_ARGS="--audit file --metrics full --json latency.json"
+ * ./aille-latency --rate 100000 --duration-s 10 --json -
+ */
@@ -0,0 +1,148 @@
+/*
+ * AILLE Hardware Counter Report
+ *
+ * Runs the three public entry points under PerfCounters and prints
+ * per-operation instructions, cycles, IPC, L1D / LLC misses, branch misses
+ * and page faults next to wall-clock ns/op:
+ *
+ *   makeDecision     AILLEEngine, mixed inputs
+ *   logDecision      AuditLogger, in-memory trail
+ *   observeDecision  MetricsCollector, default configuration
+ *
+ * Events the host does not expose (common in containers and VMs) print as
+ * "n/a"; wall-clock time is always reported.
+ *
+ * Usage: aille-perfstat [--ops N] [--models N]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "extensions/aille_perf_counters.hpp"
+
+namespace {
+
+using AILLE::PerfCounters;
+using AILLE::PerfReading;
+
+std::vector<std::vector<AILLE::ModelSignal>> makeInputs(int models) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<std::vector<AILLE::ModelSignal>> sets(1024);
+    for (auto& set : sets) {
+        float agree = unit(rng) < 0.9f ? 0.95f : 0.5f;
+        float conf_lo = unit(rng) < 0.85f ? 0.6f : 0.1f;
+        float majority = unit(rng) < 0.5f ? 1.0f : -1.0f;
+        for (int m = 0; m < models; ++m) {
+            float sign = unit(rng) < agree ? majority : -majority;
+            set.emplace_back(sign * (0.001f + 0.049f * unit(rng)),
+                             conf_lo + (0.95f - conf_lo) * unit(rng), m);
+        }
+    }
+    return sets;
+}
+
+void printCell(const PerfReading& r, int event, const char* fmt) {
+    if (r.has(event)) {
+        std::printf(fmt, r.perOp(event));
+    } else {
+        std::printf("%11s", "n/a");
+    }
+}
+
+void printRow(const char* name, const PerfReading& r) {
+    std::printf("%-16s %9.1f", name, r.nsPerOp());
+    printCell(r, AILLE::PERF_INSTRUCTIONS, "%11.1f");
+    printCell(r, AILLE::PERF_CYCLES, "%11.1f");
+    if (r.has(AILLE::PERF_INSTRUCTIONS) && r.has(AILLE::PERF_CYCLES)) {
+        std::printf("%7.2f", r.ipc());
+    } else {
+        std::printf("%7s", "n/a");
+    }
+    printCell(r, AILLE::PERF_L1D_MISSES, "%11.3f");
+    printCell(r, AILLE::PERF_LLC_MISSES, "%11.3f");
+    printCell(r, AILLE::PERF_BRANCH_MISSES, "%11.3f");
+    printCell(r, AILLE::PERF_PAGE_FAULTS, "%11.4f");
+    std::printf("\n");
+}
+
+// Runs body(i) for ops iterations once untimed, then once under the counters
+template <class Body>
+PerfReading measure(PerfCounters& counters, uint64_t ops, Body body) {
+    for (uint64_t i = 0; i < ops / 10 + 1; ++i) body(i);
+    counters.reset();
+    {
+        PerfCounters::Scope scope(counters, ops);
+        for (uint64_t i = 0; i < ops; ++i) body(i);
+    }
+    return counters.reading();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t ops = 200000;
+    int models = 8;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+            ops = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--models") == 0 && i + 1 < argc) {
+            models = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--ops N] [--models N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (ops == 0 || models <= 0) return 2;
+
+    auto inputs = makeInputs(models);
+    PerfCounters counters;
+
+    AILLE::AILLEEngine engine;
+    std::vector<AILLE::Decision> decisions;
+    decisions.reserve(inputs.size());
+    for (const auto& set : inputs) decisions.push_back(engine.makeDecision(set));
+
+    volatile float sink = 0.0f;
+    PerfReading decide = measure(counters, ops, [&](uint64_t i) {
+        sink = engine.makeDecision(inputs[i % inputs.size()]).final_value;
+    });
+
+    AILLE::AuditLogger audit;
+    PerfReading log = measure(counters, ops, [&](uint64_t i) {
+        audit.logDecision(decisions[i % decisions.size()], "BENCH", "perfstat");
+    });
+
+    AILLE::MetricsCollector collector;
+    PerfReading observe = measure(counters, ops, [&](uint64_t i) {
+        collector.observeDecision(decisions[i % decisions.size()], 800 + (i & 1023));
+    });
+    (void)sink;
+
+    std::printf("AILLE hardware counters, per operation (%llu ops, %d models)\n\n",
+                static_cast<unsigned long long>(ops), models);
+    std::printf("%-16s %9s%11s%11s%7s%11s%11s%11s%11s\n", "entry point", "ns", "instr",
+                "cycles", "IPC", "L1D miss", "LLC miss", "br miss", "faults");
+    printRow("makeDecision", decide);
+    printRow("logDecision", log);
+    printRow("observeDecision", observe);
+
+    if (!counters.unavailableReason().empty()) {
+        std::printf("\nSome counters unavailable (%s)\n", counters.unavailableReason().c_str());
+    }
+    return 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make perfstat
+ * make perfstat PERFSTAT_ARGS="--ops 1000000 --models 64"
+ */
@@ -0,0 +1,215 @@
+/*
+ * AILLE Profile-Guided Optimization Workload
+ *
+ * A scaled-up version of the examples/example.cpp signal mix, used both to
+ * train a -fprofile-generate build and to measure the result:
+ *
+ *   --train     run the decision path (makeDecision, observer, audit) so
+ *               the profile sees realistic branch frequencies
+ *   --measure   report makeDecision and full-path latency (default)
+ *
+ * Models cycle through the example's three archetypes (fundamental,
+ * technical, sentiment) with the same signal means, noise and base
+ * confidences, and the example's engine configuration. Decisions run in
+ * regimes: trending (signals agree), choppy (drift near zero, so
+ * consensus often fails) and stressed (confidence sags into the grace
+ * band or below). The realized status mix is printed so the profile's
+ * rejection rates can be checked.
+ *
+ * Usage: aille-pgo [--train | --measure] [--decisions N] [--models N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_histogram.hpp"
+#include "extensions/aille_metrics.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Archetype {
+    float mean;                        // signal drift in a trending regime
+    float noise;                       // multiple of the base noise
+    float confidence;
+};
+
+// The three models of examples/example.cpp
+const Archetype ARCHETYPES[] = {
+    {0.030f, 1.0f, 0.85f},             // fundamental: slow but reliable
+    {0.025f, 1.5f, 0.70f},             // technical: faster but noisier
+    {0.020f, 2.0f, 0.65f},             // sentiment: most volatile
+};
+
+AILLE::AILLEConfig exampleConfig() {
+    AILLE::AILLEConfig config;
+    config.min_confidence_threshold = 0.40f;
+    config.min_models_required = 2;
+    return config;
+}
+
+std::vector<std::vector<AILLE::ModelSignal>> makeWorkload(size_t count, int models,
+                                                          uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    enum Regime { TRENDING, CHOPPY, STRESSED };
+    const size_t REGIME_LENGTH = 256;
+    Regime regime = TRENDING;
+    float direction = 1.0f;
+    float severity = 0.0f;
+
+    std::vector<std::vector<AILLE::ModelSignal>> sets(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i % REGIME_LENGTH == 0) {
+            float r = unit(rng);
+            regime = r < 0.85f ? TRENDING : (r < 0.95f ? CHOPPY : STRESSED);
+            if (unit(rng) < 0.3f) direction = -direction;
+        }
+        severity = unit(rng);          // shared by all models of one decision
+        std::vector<AILLE::ModelSignal>& set = sets[i];
+        set.reserve(models);
+        for (int m = 0; m < models; ++m) {
+            const Archetype& a = ARCHETYPES[m % 3];
+            float drift = regime == CHOPPY ? 0.0f : direction * a.mean;
+            float value = drift + noise(rng) * a.noise;
+
+            float confidence = a.confidence - 0.05f * unit(rng);
+            if (regime == STRESSED) {
+                confidence -= 0.3f + 0.4f * severity + 0.1f * unit(rng);  // grace or rejected
+            } else if (unit(rng) < 0.05f) {
+                confidence = 0.25f + 0.15f * unit(rng);    // occasional grace admission
+            }
+            set.emplace_back(value, confidence, m);
+        }
+    }
+    return sets;
+}
+
+void printStatusMix(const std::vector<std::vector<AILLE::ModelSignal>>& workload) {
+    AILLE::AILLEEngine engine(exampleConfig());
+    uint64_t counts[AILLE::ERROR_NO_MODELS + 1] = {};
+    for (const auto& set : workload) ++counts[engine.makeDecision(set).status];
+    double n = static_cast<double>(workload.size());
+    std::printf("status mix: valid %.1f%%, low confidence %.1f%%, no consensus %.1f%%\n",
+                100.0 * counts[AILLE::DECISION_VALID] / n,
+                100.0 * counts[AILLE::REJECTED_LOW_CONFIDENCE] / n,
+                100.0 * counts[AILLE::REJECTED_NO_CONSENSUS] / n);
+}
+
+// Decision, metrics observer and in-memory audit, as a deployment wires them.
+// The audit trail is recycled so long runs stay within memory.
+void runFullPath(const std::vector<std::vector<AILLE::ModelSignal>>& workload,
+                 uint64_t decisions) {
+    AILLE::AILLEEngine engine(exampleConfig());
+    AILLE::MetricsCollector metrics;
+    engine.setObserver(&metrics);
+    std::unique_ptr<AILLE::AuditLogger> audit;
+    for (uint64_t i = 0; i < decisions; ++i) {
+        if (i % 65536 == 0) audit.reset(new AILLE::AuditLogger());
+        AILLE::Decision d = engine.makeDecision(workload[i % workload.size()]);
+        metrics.observeDecision(d);
+        audit->logDecision(d, "PGO", "workload");
+    }
+}
+
+double medianOf(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+void measure(const std::vector<std::vector<AILLE::ModelSignal>>& workload,
+             uint64_t decisions) {
+    const int REPETITIONS = 7;
+    volatile float sink = 0.0f;
+
+    // Batch cost without per-call clock reads
+    std::vector<double> decide_ns, full_ns;
+    for (int rep = 0; rep < REPETITIONS; ++rep) {
+        AILLE::AILLEEngine engine(exampleConfig());
+        auto start = Clock::now();
+        for (uint64_t i = 0; i < decisions; ++i) {
+            sink = engine.makeDecision(workload[i % workload.size()]).final_value;
+        }
+        decide_ns.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                            static_cast<double>(decisions));
+
+        start = Clock::now();
+        runFullPath(workload, decisions / 4);
+        full_ns.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() /
+                          static_cast<double>(decisions / 4));
+    }
+
+    // Per-call distribution of makeDecision
+    AILLE::LogLinearHistogram latency(AILLE::HistogramConfig(1.0, 1e9, 10));
+    AILLE::AILLEEngine engine(exampleConfig());
+    for (uint64_t i = 0; i < decisions; ++i) {
+        auto begin = Clock::now();
+        sink = engine.makeDecision(workload[i % workload.size()]).final_value;
+        latency.record(static_cast<double>((Clock::now() - begin).count()));
+    }
+    (void)sink;
+
+    std::printf("makeDecision            %8.1f ns/op (median of %d)\n", medianOf(decide_ns),
+                REPETITIONS);
+    std::printf("decision+metrics+audit  %8.1f ns/op (median of %d)\n", medianOf(full_ns),
+                REPETITIONS);
+    std::printf("makeDecision per call   p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  max %.0f ns\n",
+                latency.percentile(50.0), latency.percentile(90.0), latency.percentile(99.0),
+                latency.percentile(99.9), latency.getMax());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool train = false;
+    uint64_t decisions = 0;
+    int models = 9;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--train") == 0) {
+            train = true;
+        } else if (std::strcmp(argv[i], "--measure") == 0) {
+            train = false;
+        } else if (std::strcmp(argv[i], "--decisions") == 0 && i + 1 < argc) {
+            decisions = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--models") == 0 && i + 1 < argc) {
+            models = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--train | --measure] [--decisions N] [--models N]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+    if (models <= 0) return 2;
+    if (decisions == 0) decisions = train ? 1000000 : 400000;
+
+    // Training and measurement use different seeds, so the measured run is
+    // not the exact input the profile was recorded on
+    auto workload = makeWorkload(65536, models, train ? 1u : 2u);
+    std::printf("AILLE PGO workload: %s, %llu decisions, %d models\n",
+                train ? "train" : "measure", static_cast<unsigned long long>(decisions), models);
+    printStatusMix(workload);
+
+    if (train) {
+        runFullPath(workload, decisions);
+    } else {
+        measure(workload, decisions);
+    }
+    return 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make pgo-generate pgo-train pgo-use    # instrument, train, rebuild with profile
+ * make pgo-baseline                      # same workload without PGO, for comparison
+ */
@@ -0,0 +1,341 @@
+/*
+ * AILLE Benchmarks - Minimal Harness
+ *
+ * Dependency-free timing loop shared by the programs in bench/. A
+ * benchmark body runs a given number of iterations; the harness grows the
+ * count until one repetition lasts at least min_time, then times
+ * `repetitions` repetitions and reports the median (and spread) of the
+ * per-operation cost. An optional setup callback runs before every timed
+ * repetition, outside the clock.
+ *
+ * Common flags: --filter SUBSTR[,SUBSTR...]  --min-time-ms N  --reps N
+ *               --json PATH  --list
+ *
+ * --json writes every repetition's ns/op together with an environment
+ * fingerprint (CPU model, compiler, build flags) for
+ * tools/aille_bench_compare.cpp.
+ */
+
+#ifndef AILLE_BENCH_HARNESS_HPP
+#define AILLE_BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Set by the Makefile so results record how they were built
+#ifndef AILLE_BENCH_FLAGS
+#define AILLE_BENCH_FLAGS "unknown"
+#endif
+
+namespace AILLE {
+namespace bench {
+
+// ============================================================================
+// OPTIMIZATION BARRIERS
+// ============================================================================
+
+// Forces `value` to be materialized, so the work producing it is kept
+template <class T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Treats all memory as read and written at this point
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#endif
+}
+
+// ============================================================================
+// OPTIONS / RESULTS
+// ============================================================================
+
+struct BenchOptions {
+    double min_time_s;                 // Default: 20 ms per repetition
+    int repetitions;                   // Default: 5
+    std::string filter;                // Default: "" (run everything); comma-separated
+    std::string json_path;             // Default: "" (no JSON output)
+    bool list_only;                    // Default: false
+
+    BenchOptions()
+        : min_time_s(0.02),
+          repetitions(5),
+          filter(),
+          json_path(),
+          list_only(false) {}
+
+    // Parses the common flags; unknown flags are reported and rejected
+    bool parse(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+                filter = argv[++i];
+            } else if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+                min_time_s = std::max(0.001, std::atof(argv[++i]) / 1000.0);
+            } else if (std::strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+                repetitions = std::max(1, std::atoi(argv[++i]));
+            } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+                json_path = argv[++i];
+            } else if (std::strcmp(argv[i], "--list") == 0) {
+                list_only = true;
+            } else {
+                std::fprintf(stderr,
+                             "usage: %s [--filter SUBSTR[,SUBSTR...]] [--min-time-ms N] [--reps N] "
+                             "[--json PATH] [--list]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;           // per repetition
+    std::vector<double> ns_per_op;     // one entry per repetition
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    double mean_ns = 0.0;
+    double stddev_ns = 0.0;            // sample standard deviation across repetitions
+    bool optimized_away = false;       // calibration hit the iteration cap; timings are void
+};
+
+// ============================================================================
+// ENVIRONMENT FINGERPRINT
+// ============================================================================
+
+// Where and how a result file was produced; comparisons across different
+// fingerprints are reported but are not like-for-like
+struct BenchEnvironment {
+    std::string cpu_model;
+    unsigned cpu_count = 0;
+    std::string compiler;
+    std::string flags;
+    std::string timestamp;             // UTC, ISO 8601
+
+    static BenchEnvironment capture() {
+        BenchEnvironment env;
+        env.cpu_model = "unknown";
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0 || line.compare(0, 9, "Processor") == 0) {
+                size_t colon = line.find(':');
+                if (colon != std::string::npos && colon + 2 <= line.size()) {
+                    env.cpu_model = line.substr(colon + 2);
+                    break;
+                }
+            }
+        }
+        env.cpu_count = std::thread::hardware_concurrency();
+#if defined(__clang__)
+        env.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+        env.compiler = std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+        env.compiler = "msvc " + std::to_string(_MSC_VER);
+#else
+        env.compiler = "unknown";
+#endif
+        env.flags = AILLE_BENCH_FLAGS;
+
+        std::time_t now = std::time(nullptr);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        env.timestamp = buf;
+        return env;
+    }
+};
+
+inline std::string jsonEscape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// ============================================================================
+// RUNNER
+// ============================================================================
+
+class BenchRunner {
+private:
+    BenchOptions options;
+    std::vector<BenchResult> results;
+    bool header_printed = false;
+
+    using Clock = std::chrono::steady_clock;
+
+public:
+    explicit BenchRunner(const BenchOptions& opts = BenchOptions()) : options(opts) {}
+
+    bool selected(const std::string& name) const {
+        if (options.filter.empty()) return true;
+        size_t start = 0;
+        while (start <= options.filter.size()) {
+            size_t comma = options.filter.find(',', start);
+            if (comma == std::string::npos) comma = options.filter.size();
+            std::string part = options.filter.substr(start, comma - start);
+            if (!part.empty() && name.find(part) != std::string::npos) return true;
+            start = comma + 1;
+        }
+        return false;
+    }
+
+    template <class Body>
+    void run(const std::string& name, Body body) {
+        run(name, body, []() {});
+    }
+
+    // body(iterations) performs `iterations` operations; setup() runs
+    // untimed before each call
+    template <class Body, class Setup>
+    void run(const std::string& name, Body body, Setup setup) {
+        if (!selected(name)) return;
+        if (options.list_only) {
+            std::printf("%s\n", name.c_str());
+            return;
+        }
+        printHeader();
+
+        // Calibrate: grow until one repetition reaches min_time
+        // The cap catches bodies the optimizer removed entirely
+        const uint64_t max_iterations = uint64_t(1) << 32;
+        uint64_t iterations = 1;
+        while (true) {
+            setup();
+            double t = timeOnce(body, iterations);
+            if (t >= options.min_time_s || iterations >= max_iterations) break;
+            double factor = (t > 0.0) ? 1.4 * options.min_time_s / t : 10.0;
+            factor = std::min(10.0, std::max(2.0, factor));
+            iterations = std::min(max_iterations,
+                                  static_cast<uint64_t>(std::ceil(iterations * factor)));
+        }
+
+        BenchResult r;
+        r.name = name;
+        r.iterations = iterations;
+        r.optimized_away = iterations >= max_iterations;
+        for (int rep = 0; rep < options.repetitions; ++rep) {
+            setup();
+            r.ns_per_op.push_back(timeOnce(body, iterations) * 1e9 / iterations);
+        }
+        summarize(r);
+        printRow(r);
+        results.push_back(r);
+    }
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+    const BenchOptions& getOptions() const { return options; }
+
+    // Writes all results so far; returns false if the file cannot be written
+    bool writeJson(const std::string& path) const {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) return false;
+
+        BenchEnvironment env = BenchEnvironment::capture();
+        std::fprintf(f, "{\n  \"format\": \"aille-bench-v1\",\n");
+        std::fprintf(f, "  \"environment\": {\"cpu_model\": \"%s\", \"cpu_count\": %u, "
+                        "\"compiler\": \"%s\", \"flags\": \"%s\", \"timestamp\": \"%s\"},\n",
+                     jsonEscape(env.cpu_model).c_str(), env.cpu_count,
+                     jsonEscape(env.compiler).c_str(), jsonEscape(env.flags).c_str(),
+                     env.timestamp.c_str());
+        std::fprintf(f, "  \"options\": {\"min_time_ms\": %.1f, \"repetitions\": %d},\n",
+                     options.min_time_s * 1e3, options.repetitions);
+        std::fprintf(f, "  \"benchmarks\": [");
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            std::fprintf(f, "%s\n    {\"name\": \"%s\", \"iterations\": %llu, "
+                            "\"median_ns\": %.4f, \"mean_ns\": %.4f, \"stddev_ns\": %.4f, "
+                            "\"optimized_away\": %s, \"samples_ns\": [",
+                         i ? "," : "", jsonEscape(r.name).c_str(),
+                         static_cast<unsigned long long>(r.iterations), r.median_ns, r.mean_ns,
+                         r.stddev_ns, r.optimized_away ? "true" : "false");
+            for (size_t k = 0; k < r.ns_per_op.size(); ++k) {
+                std::fprintf(f, "%s%.4f", k ? ", " : "", r.ns_per_op[k]);
+            }
+            std::fprintf(f, "]}");
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+        return std::fclose(f) == 0;
+    }
+
+private:
+    template <class Body>
+    static double timeOnce(Body& body, uint64_t iterations) {
+        clobberMemory();
+        auto start = Clock::now();
+        body(iterations);
+        clobberMemory();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    static void summarize(BenchResult& r) {
+        std::vector<double> sorted = r.ns_per_op;
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        r.median_ns = (n % 2) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        r.min_ns = sorted.front();
+        double sum = 0.0;
+        for (double v : sorted) sum += v;
+        r.mean_ns = sum / n;
+        double sq = 0.0;
+        for (double v : sorted) sq += (v - r.mean_ns) * (v - r.mean_ns);
+        r.stddev_ns = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+    }
+
+    void printHeader() {
+        if (header_printed) return;
+        header_printed = true;
+        std::printf("%-52s %12s %12s %12s %8s %14s\n", "benchmark", "iterations",
+                    "median ns", "min ns", "cv %", "ops/s");
+        std::printf("%s\n", std::string(114, '-').c_str());
+    }
+
+    static void printRow(const BenchResult& r) {
+        if (r.optimized_away) {
+            std::printf("%-52s %12llu %12s %12s %8s %14s\n", r.name.c_str(),
+                        static_cast<unsigned long long>(r.iterations), "-", "-", "-",
+                        "optimized away");
+            std::fflush(stdout);
+            return;
+        }
+        double cv = r.mean_ns > 0.0 ? 100.0 * r.stddev_ns / r.mean_ns : 0.0;
+        char rate[32] = "inf";
+        if (r.median_ns >= 0.01) std::snprintf(rate, sizeof(rate), "%.0f", 1e9 / r.median_ns);
+        std::printf("%-52s %12llu %12.1f %12.1f %8.2f %14s\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iterations), r.median_ns, r.min_ns, cv,
+                    rate);
+        std::fflush(stdout);
+    }
+};
+
+} // namespace bench
+} // namespace AILLE
+
+#endif // AILLE_BENCH_HARNESS_HPP
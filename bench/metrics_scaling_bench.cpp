@@ -0,0 +1,109 @@
+/*
+ * AILLE Metrics - Thread Scaling Benchmark
+ *
+ * Compares MetricsCollector (single mutex) with ShardedMetricsCollector
+ * (per-thread cache-line aligned shards) when one collector is shared by
+ * 1 to 64 decision threads.
+ *
+ * Reports aggregate observeDecision() throughput for each thread count.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "extensions/aille_metrics_sharded.hpp"
+
+namespace {
+
+std::vector<AILLE::Decision> makeDecisions(size_t count) {
+    std::vector<AILLE::Decision> out(count);
+    for (size_t i = 0; i < count; ++i) {
+        AILLE::Decision& d = out[i];
+        d.timestamp_ns = 1000000000ULL + i;
+        d.confidence = 0.3f + 0.6f * static_cast<float>(i % 97) / 97.0f;
+        d.models_agreed = static_cast<int>(i % 5);
+        switch (i % 20) {
+            case 0:  d.status = AILLE::REJECTED_LOW_CONFIDENCE; d.fallback_used = true; break;
+            case 1:  d.status = AILLE::REJECTED_NO_CONSENSUS;   d.fallback_used = true; break;
+            default: d.status = AILLE::DECISION_VALID;          break;
+        }
+    }
+    return out;
+}
+
+// Runs ops_per_thread observations on each of `threads` threads and
+// returns aggregate throughput in millions of decisions per second.
+template <typename Collector>
+double runScaling(Collector& collector, int threads, size_t ops_per_thread,
+                  const std::vector<AILLE::Decision>& decisions) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            size_t idx = static_cast<size_t>(t) * 7919;
+            for (size_t i = 0; i < ops_per_thread; ++i) {
+                collector.observeDecision(decisions[idx % decisions.size()]);
+                ++idx;
+            }
+        });
+    }
+
+    while (ready.load() < threads) std::this_thread::yield();
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(ops_per_thread) * threads / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t ops_per_thread = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const int thread_counts[] = {1, 2, 4, 8, 16, 32, 64};
+    auto decisions = makeDecisions(4096);
+
+    std::printf("AILLE metrics scaling (%zu observations per thread, %u hardware threads)\n\n",
+                ops_per_thread, std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s %8s\n", "threads", "mutex (Mops/s)", "sharded (Mops/s)", "speedup");
+
+    for (int threads : thread_counts) {
+        AILLE::MetricsCollector locked;
+        AILLE::ShardedMetricsCollector sharded;
+
+        double locked_rate = runScaling(locked, threads, ops_per_thread, decisions);
+        double sharded_rate = runScaling(sharded, threads, ops_per_thread, decisions);
+
+        // Both collectors must agree on what they counted
+        if (locked.getSnapshot().total_decisions != sharded.getSnapshot().total_decisions) {
+            std::fprintf(stderr, "count mismatch at %d threads\n", threads);
+            return 1;
+        }
+
+        std::printf("%8d %18.2f %18.2f %7.2fx\n",
+                    threads, locked_rate, sharded_rate, sharded_rate / locked_rate);
+    }
+
+    return 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make scaling-bench                          # build and run
+ * make scaling-bench SCALING_ARGS="500000"    # observations per thread
+ * ./aille-scaling-bench [observations_per_thread]
+ */
@@ -0,0 +1,421 @@
+/*
+ * AILLE Metrics Extension - Drift Alerting
+ * Online rate-of-change detectors on AILLE health signals
+ *
+ * License: MIT (see LICENSE)
+ *
+ * isHealthy() compares a lifetime rate to a fixed threshold, so it reacts
+ * late to a fast shift and never to a slow drift away from a healthy
+ * baseline. AlertingEngine instead tracks three per-bucket signals:
+ *
+ *   - fallback rate
+ *   - consensus failure rate
+ *   - mean confidence
+ *
+ * against a slowly adapting baseline (exponentially weighted mean and
+ * variance), and runs two classic change detectors on each:
+ *
+ *   - EWMA control chart: smoothed signal outside mu +/- L*sigma*sqrt(l/(2-l))
+ *   - two-sided CUSUM:    accumulated (z - k) beyond h standard deviations
+ *
+ * Each decision is O(1) (a few increments); detectors run once per bucket.
+ * Alerts go to a bounded queue and callbacks run on a dispatcher thread (or
+ * via dispatchPending()), never on the deciding thread.
+ */
+
+#ifndef AILLE_ALERTING_HPP
+#define AILLE_ALERTING_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// ALERT TYPES
+// ============================================================================
+
+enum AlertSignal {
+    ALERT_FALLBACK_RATE,
+    ALERT_CONSENSUS_FAILURE_RATE,
+    ALERT_MEAN_CONFIDENCE,
+    ALERT_SIGNAL_COUNT
+};
+
+enum AlertDetector {
+    DETECTOR_EWMA,
+    DETECTOR_CUSUM,
+    DETECTOR_COUNT
+};
+
+enum AlertDirection {
+    ALERT_RISING,
+    ALERT_FALLING
+};
+
+struct Alert {
+    AlertSignal signal = ALERT_FALLBACK_RATE;
+    AlertDetector detector = DETECTOR_EWMA;
+    AlertDirection direction = ALERT_RISING;
+    double value = 0.0;           // bucket value that triggered the alert
+    double baseline = 0.0;        // baseline mean at the time
+    double statistic = 0.0;       // EWMA deviation or CUSUM sum, in sigmas
+    uint64_t bucket_index = 0;
+    uint64_t timestamp_ns = 0;    // last decision in the bucket
+};
+
+inline const char* alertSignalName(AlertSignal s) {
+    switch (s) {
+        case ALERT_FALLBACK_RATE: return "fallback_rate";
+        case ALERT_CONSENSUS_FAILURE_RATE: return "consensus_failure_rate";
+        case ALERT_MEAN_CONFIDENCE: return "mean_confidence";
+        default: return "unknown";
+    }
+}
+
+inline std::string formatAlert(const Alert& a) {
+    std::string out = alertSignalName(a.signal);
+    out += a.direction == ALERT_RISING ? " rising" : " falling";
+    out += a.detector == DETECTOR_EWMA ? " (EWMA)" : " (CUSUM)";
+    out += ": value=" + std::to_string(a.value) +
+           " baseline=" + std::to_string(a.baseline) +
+           " statistic=" + std::to_string(a.statistic) +
+           " bucket=" + std::to_string(a.bucket_index);
+    return out;
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+struct AlertingConfig {
+    uint64_t bucket_decisions;     // Default: 100 decisions per evaluation
+    uint64_t warmup_buckets;       // Default: 20 (baseline only, no alerts)
+    double baseline_alpha;         // Default: 0.01 (baseline adaptation speed)
+    double min_sigma;              // Default: 0.005 (floor for quiet baselines)
+
+    double ewma_lambda;            // Default: 0.2
+    double ewma_width;             // Default: 3.5 (L, control limit in sigmas)
+
+    double cusum_k;                // Default: 0.5 (slack, in sigmas)
+    double cusum_h;                // Default: 8.0 (decision interval, in sigmas)
+
+    uint64_t cooldown_buckets;     // Default: 50 (per signal/detector/direction)
+    size_t queue_capacity;         // Default: 256 (excess alerts are dropped)
+
+    AlertingConfig()
+        : bucket_decisions(100),
+          warmup_buckets(20),
+          baseline_alpha(0.01),
+          min_sigma(0.005),
+          ewma_lambda(0.2),
+          ewma_width(3.5),
+          cusum_k(0.5),
+          cusum_h(8.0),
+          cooldown_buckets(50),
+          queue_capacity(256) {}
+};
+
+// ============================================================================
+// PER-SIGNAL DETECTOR STATE (O(1) UPDATE)
+// ============================================================================
+
+struct DriftDetectorState {
+    uint64_t buckets = 0;
+    double baseline_mean = 0.0;
+    double baseline_var = 0.0;
+    double ewma = 0.0;
+    double cusum_high = 0.0;
+    double cusum_low = 0.0;
+    uint64_t cooldown_until[DETECTOR_COUNT][2] = {};
+
+    double sigma(double floor) const { return std::max(std::sqrt(baseline_var), floor); }
+};
+
+// ============================================================================
+// ALERTING ENGINE
+// ============================================================================
+
+class AlertingEngine {
+public:
+    using AlertCallback = std::function<void(const Alert&)>;
+
+private:
+    AlertingConfig config;
+
+    // Hot-path state (protected by mtx)
+    mutable std::mutex mtx;
+    uint64_t bucket_count = 0;
+    uint64_t bucket_fallbacks = 0;
+    uint64_t bucket_consensus_failures = 0;
+    double bucket_confidence_sum = 0.0;
+    uint64_t bucket_last_timestamp_ns = 0;
+    uint64_t bucket_index = 0;
+    DriftDetectorState detectors[ALERT_SIGNAL_COUNT];
+
+    // Bounded alert ring (protected by queue_mtx)
+    std::mutex queue_mtx;
+    std::condition_variable queue_cv;
+    std::vector<Alert> queue;
+    size_t queue_head = 0;
+    size_t queue_size = 0;
+    uint64_t alerts_raised = 0;
+    uint64_t alerts_dropped = 0;
+
+    // Dispatcher
+    std::mutex callback_mtx;
+    std::vector<AlertCallback> callbacks;
+    std::thread dispatcher;
+    bool running = false;          // protected by queue_mtx
+
+public:
+    explicit AlertingEngine(const AlertingConfig& cfg = AlertingConfig())
+        : config(cfg), queue(std::max<size_t>(1, cfg.queue_capacity)) {
+        config.bucket_decisions = std::max<uint64_t>(1, config.bucket_decisions);
+    }
+
+    ~AlertingEngine() { stop(); }
+
+    AlertingEngine(const AlertingEngine&) = delete;
+    AlertingEngine& operator=(const AlertingEngine&) = delete;
+
+    // O(1) per decision; detectors run when a bucket fills
+    void observeDecision(const Decision& d) {
+        if (!isObservableDecision(d)) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        bucket_count++;
+        if (d.status == REJECTED_LOW_CONFIDENCE || d.status == REJECTED_NO_CONSENSUS ||
+            d.status == FALLBACK_ACTIVATED) {
+            bucket_fallbacks++;
+        }
+        if (d.status == REJECTED_NO_CONSENSUS) bucket_consensus_failures++;
+        bucket_confidence_sum += d.confidence;
+        bucket_last_timestamp_ns = d.timestamp_ns;
+
+        if (bucket_count >= config.bucket_decisions) {
+            double n = static_cast<double>(bucket_count);
+            evaluateLocked(bucket_fallbacks / n, bucket_consensus_failures / n,
+                           bucket_confidence_sum / n, bucket_last_timestamp_ns);
+            bucket_count = 0;
+            bucket_fallbacks = 0;
+            bucket_consensus_failures = 0;
+            bucket_confidence_sum = 0.0;
+        }
+    }
+
+    // Feed pre-aggregated buckets instead, e.g. successive
+    // MetricsCollector::getSnapshot(std::chrono::minutes(1)) results
+    void observeBucket(double fallback_rate, double consensus_failure_rate,
+                       double mean_confidence, uint64_t timestamp_ns = 0) {
+        std::lock_guard<std::mutex> lock(mtx);
+        evaluateLocked(fallback_rate, consensus_failure_rate, mean_confidence, timestamp_ns);
+    }
+
+    void observeBucket(const MetricsSnapshot& window) {
+        if (window.total_decisions == 0) return;
+        observeBucket(window.fallback_rate, window.consensus_failure_rate,
+                      window.average_confidence, window.last_decision_timestamp_ns);
+    }
+
+    void addCallback(AlertCallback cb) {
+        std::lock_guard<std::mutex> lock(callback_mtx);
+        callbacks.push_back(std::move(cb));
+    }
+
+    // Background dispatcher; without it, call dispatchPending() periodically
+    void start() {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        if (running) return;
+        running = true;
+        dispatcher = std::thread([this]() { dispatchLoop(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            if (!running) return;
+            running = false;
+        }
+        queue_cv.notify_all();
+        if (dispatcher.joinable()) dispatcher.join();
+    }
+
+    // Runs callbacks for queued alerts on the calling thread
+    size_t dispatchPending() {
+        size_t delivered = 0;
+        Alert a;
+        while (popAlert(a)) {
+            deliver(a);
+            ++delivered;
+        }
+        return delivered;
+    }
+
+    DriftDetectorState getDetectorState(AlertSignal s) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return detectors[s];
+    }
+
+    uint64_t getBucketIndex() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return bucket_index;
+    }
+
+    uint64_t getAlertsRaised() {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        return alerts_raised;
+    }
+
+    uint64_t getAlertsDropped() {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        return alerts_dropped;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mtx);
+        bucket_count = 0;
+        bucket_fallbacks = 0;
+        bucket_consensus_failures = 0;
+        bucket_confidence_sum = 0.0;
+        bucket_index = 0;
+        for (auto& d : detectors) d = DriftDetectorState();
+    }
+
+private:
+    void evaluateLocked(double fallback_rate, double consensus_failure_rate,
+                        double mean_confidence, uint64_t timestamp_ns) {
+        const double values[ALERT_SIGNAL_COUNT] = {fallback_rate, consensus_failure_rate,
+                                                   mean_confidence};
+        for (int s = 0; s < ALERT_SIGNAL_COUNT; ++s) {
+            update(static_cast<AlertSignal>(s), values[s], timestamp_ns);
+        }
+        bucket_index++;
+    }
+
+    void update(AlertSignal signal, double x, uint64_t timestamp_ns) {
+        DriftDetectorState& st = detectors[signal];
+
+        if (st.buckets < config.warmup_buckets) {
+            // Plain running mean/variance until the baseline is established
+            updateBaseline(st, x, 1.0 / static_cast<double>(st.buckets + 1));
+            st.ewma = st.baseline_mean;
+            st.buckets++;
+            return;
+        }
+
+        double mu = st.baseline_mean;
+        double sigma = st.sigma(config.min_sigma);
+
+        // EWMA control chart (asymptotic limits)
+        double lambda = config.ewma_lambda;
+        st.ewma = lambda * x + (1.0 - lambda) * st.ewma;
+        double limit = config.ewma_width * sigma * std::sqrt(lambda / (2.0 - lambda));
+        if (st.ewma > mu + limit) {
+            raise(st, signal, DETECTOR_EWMA, ALERT_RISING, x, (st.ewma - mu) / sigma, timestamp_ns);
+        } else if (st.ewma < mu - limit) {
+            raise(st, signal, DETECTOR_EWMA, ALERT_FALLING, x, (st.ewma - mu) / sigma, timestamp_ns);
+        }
+
+        // Two-sided CUSUM in standardized units; restarts after an alarm
+        double z = (x - mu) / sigma;
+        st.cusum_high = std::max(0.0, st.cusum_high + z - config.cusum_k);
+        st.cusum_low = std::max(0.0, st.cusum_low - z - config.cusum_k);
+        if (st.cusum_high > config.cusum_h) {
+            raise(st, signal, DETECTOR_CUSUM, ALERT_RISING, x, st.cusum_high, timestamp_ns);
+            st.cusum_high = 0.0;
+        }
+        if (st.cusum_low > config.cusum_h) {
+            raise(st, signal, DETECTOR_CUSUM, ALERT_FALLING, x, -st.cusum_low, timestamp_ns);
+            st.cusum_low = 0.0;
+        }
+
+        // Slow adaptation: a sustained new level eventually becomes normal
+        updateBaseline(st, x, config.baseline_alpha);
+        st.buckets++;
+    }
+
+    // Exponentially weighted mean and variance (West, 1979)
+    static void updateBaseline(DriftDetectorState& st, double x, double alpha) {
+        double diff = x - st.baseline_mean;
+        double incr = alpha * diff;
+        st.baseline_mean += incr;
+        st.baseline_var = (1.0 - alpha) * (st.baseline_var + diff * incr);
+    }
+
+    void raise(DriftDetectorState& st, AlertSignal signal, AlertDetector detector,
+               AlertDirection direction, double value, double statistic,
+               uint64_t timestamp_ns) {
+        uint64_t& cooldown = st.cooldown_until[detector][direction];
+        if (bucket_index < cooldown) return;
+        cooldown = bucket_index + config.cooldown_buckets;
+
+        Alert a;
+        a.signal = signal;
+        a.detector = detector;
+        a.direction = direction;
+        a.value = value;
+        a.baseline = st.baseline_mean;
+        a.statistic = statistic;
+        a.bucket_index = bucket_index;
+        a.timestamp_ns = timestamp_ns;
+        pushAlert(a);
+    }
+
+    // Called with mtx held; queue_mtx is only ever taken after mtx here
+    void pushAlert(const Alert& a) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            alerts_raised++;
+            if (queue_size == queue.size()) {
+                alerts_dropped++;
+                return;
+            }
+            queue[(queue_head + queue_size) % queue.size()] = a;
+            queue_size++;
+        }
+        queue_cv.notify_one();
+    }
+
+    bool popAlert(Alert& out) {
+        std::lock_guard<std::mutex> lock(queue_mtx);
+        if (queue_size == 0) return false;
+        out = queue[queue_head];
+        queue_head = (queue_head + 1) % queue.size();
+        queue_size--;
+        return true;
+    }
+
+    void deliver(const Alert& a) {
+        std::lock_guard<std::mutex> lock(callback_mtx);
+        for (auto& cb : callbacks) cb(a);
+    }
+
+    void dispatchLoop() {
+        while (true) {
+            Alert a;
+            {
+                std::unique_lock<std::mutex> lock(queue_mtx);
+                queue_cv.wait(lock, [this]() { return queue_size > 0 || !running; });
+                if (queue_size == 0) return;   // stopped and drained
+                a = queue[queue_head];
+                queue_head = (queue_head + 1) % queue.size();
+                queue_size--;
+            }
+            deliver(a);
+        }
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_ALERTING_HPP
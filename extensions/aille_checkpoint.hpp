@@ -0,0 +1,248 @@
+/*
+ * AILLE Metrics Extension - Checkpoint / Restore
+ * Persist collector state across process restarts
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Writes MetricsCollector::saveState() images to disk and maps them back
+ * in on startup, so counters, confidence windows, quantile sketches and
+ * histograms survive a restart instead of re-learning from zero (see
+ * "Establishing a Baseline" in docs/metrics_thresholds.md).
+ *
+ *   - saveMetricsCheckpoint(): write <path>.tmp, fsync, rename over <path>,
+ *     fsync the directory. A crash leaves either the old or the new file,
+ *     never a torn one.
+ *   - loadMetricsCheckpoint(): mmap the file read-only and decode in place;
+ *     the checksum and configuration fingerprint reject corrupt or
+ *     incompatible files.
+ *   - MetricsCheckpointer: background thread checkpointing every interval,
+ *     plus a final checkpoint on stop().
+ *
+ * POSIX only; the functions return false on other platforms.
+ */
+
+#ifndef AILLE_CHECKPOINT_HPP
+#define AILLE_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define AILLE_HAS_POSIX_FILES 1
+#endif
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// ATOMIC FILE WRITE / MMAP RESTORE
+// ============================================================================
+
+#ifdef AILLE_HAS_POSIX_FILES
+namespace detail {
+
+inline bool writeFully(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+inline void syncParentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    std::string dir = (slash == std::string::npos) ? "." : path.substr(0, slash + 1);
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+} // namespace detail
+#endif
+
+// Writes an already-serialized image durably and atomically to `path`
+inline bool writeCheckpointFile(const std::string& path, const std::vector<uint8_t>& image) {
+#ifdef AILLE_HAS_POSIX_FILES
+    std::string tmp = path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    bool ok = detail::writeFully(fd, image.data(), image.size()) && ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || ::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    detail::syncParentDirectory(path);
+    return true;
+#else
+    (void)path;
+    (void)image;
+    return false;
+#endif
+}
+
+inline bool saveMetricsCheckpoint(const MetricsCollector& collector, const std::string& path) {
+    std::vector<uint8_t> image;
+    collector.saveState(image);
+    return writeCheckpointFile(path, image);
+}
+
+// Restores `collector` from `path`. Returns false if the file is missing,
+// corrupt or was written with a different collector configuration; the
+// collector is then left as it was.
+inline bool loadMetricsCheckpoint(MetricsCollector& collector, const std::string& path) {
+#ifdef AILLE_HAS_POSIX_FILES
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+
+    bool ok = collector.loadState(static_cast<const uint8_t*>(mapped), size);
+    ::munmap(mapped, size);
+    return ok;
+#else
+    (void)collector;
+    (void)path;
+    return false;
+#endif
+}
+
+// ============================================================================
+// PERIODIC CHECKPOINTER
+// ============================================================================
+
+struct CheckpointerConfig {
+    std::chrono::milliseconds interval;    // Default: 30 s
+    bool restore_on_start;                 // Default: true (load existing file)
+    bool checkpoint_on_stop;               // Default: true (final write)
+
+    CheckpointerConfig()
+        : interval(30000),
+          restore_on_start(true),
+          checkpoint_on_stop(true) {}
+};
+
+class MetricsCheckpointer {
+private:
+    MetricsCollector& collector;
+    std::string path;
+    CheckpointerConfig config;
+    std::vector<uint8_t> image;            // reused across checkpoints
+    std::unique_ptr<MetricsCollector::StateScratch> state;  // raw copy, reused
+    std::mutex write_mtx;                  // serializes checkpointNow() callers
+
+    std::thread checkpoint_thread;
+    std::mutex state_mtx;
+    std::condition_variable state_cv;
+    bool running = false;                  // protected by state_mtx
+
+    std::atomic<bool> restored{false};
+    std::atomic<uint64_t> checkpoints{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> last_checkpoint_bytes{0};
+
+public:
+    MetricsCheckpointer(MetricsCollector& c, const std::string& file,
+                        const CheckpointerConfig& cfg = CheckpointerConfig())
+        : collector(c), path(file), config(cfg) {}
+
+    ~MetricsCheckpointer() { stop(); }
+
+    MetricsCheckpointer(const MetricsCheckpointer&) = delete;
+    MetricsCheckpointer& operator=(const MetricsCheckpointer&) = delete;
+
+    // Restores from the existing file (if configured) and starts the
+    // background thread. A missing or incompatible file is not an error;
+    // check wasRestored().
+    bool start() {
+        std::lock_guard<std::mutex> lock(state_mtx);
+        if (running) return true;
+#ifndef AILLE_HAS_POSIX_FILES
+        return false;
+#else
+        if (config.restore_on_start) {
+            restored.store(loadMetricsCheckpoint(collector, path), std::memory_order_relaxed);
+        }
+        running = true;
+        checkpoint_thread = std::thread([this]() {
+            std::unique_lock<std::mutex> state(state_mtx);
+            while (running) {
+                state_cv.wait_for(state, config.interval, [this]() { return !running; });
+                if (!running) break;
+                state.unlock();
+                checkpointNow();
+                state.lock();
+            }
+        });
+        return true;
+#endif
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(state_mtx);
+            if (!running) return;
+            running = false;
+        }
+        state_cv.notify_all();
+        if (checkpoint_thread.joinable()) checkpoint_thread.join();
+        if (config.checkpoint_on_stop) checkpointNow();
+    }
+
+    // Synchronous checkpoint; the collector lock is held only while its
+    // raw state is copied, not while it is encoded or written
+    bool checkpointNow() {
+        std::lock_guard<std::mutex> lock(write_mtx);
+        if (!state) state.reset(new MetricsCollector::StateScratch(collector.makeStateScratch()));
+        collector.saveState(image, *state);
+        bool ok = writeCheckpointFile(path, image);
+        if (ok) {
+            checkpoints.fetch_add(1, std::memory_order_relaxed);
+            last_checkpoint_bytes.store(image.size(), std::memory_order_relaxed);
+        } else {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        return ok;
+    }
+
+    bool wasRestored() const { return restored.load(std::memory_order_relaxed); }
+    uint64_t getCheckpointCount() const { return checkpoints.load(std::memory_order_relaxed); }
+    uint64_t getFailureCount() const { return failures.load(std::memory_order_relaxed); }
+    uint64_t getLastCheckpointBytes() const {
+        return last_checkpoint_bytes.load(std::memory_order_relaxed);
+    }
+    const std::string& getPath() const { return path; }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_CHECKPOINT_HPP
@@ -0,0 +1,360 @@
+/*
+ * AILLE Metrics Extension - Log-Linear Histogram
+ * HDR-style bucketed distributions with bounded relative error
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Values are quantized to integer multiples of `unit`, then bucketed the
+ * way HdrHistogram does it: exact below 2^precision_bits, and above that
+ * 2^(precision_bits-1) linear sub-buckets per power of two. Recording is
+ * O(1) (one count-leading-zeros and one increment), memory is fixed at
+ * construction, and two histograms with the same configuration merge by
+ * adding counts - across threads, or across processes via encode/decode.
+ *
+ * Not internally synchronized; owners (e.g. MetricsCollector) lock.
+ */
+
+#ifndef AILLE_HISTOGRAM_HPP
+#define AILLE_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace AILLE {
+
+// ============================================================================
+// HISTOGRAM CONFIGURATION
+// ============================================================================
+
+struct HistogramConfig {
+    double unit;              // Value resolution (smallest distinguishable step)
+    double max_value;         // Largest tracked magnitude; larger values clamp
+    int precision_bits;       // Relative error <= 2^-precision_bits (7 -> <0.8%)
+    bool allow_negative;      // Mirror buckets for negative values
+
+    HistogramConfig()
+        : unit(1.0),
+          max_value(1e10),
+          precision_bits(7),
+          allow_negative(false) {}
+
+    HistogramConfig(double unit_, double max_value_, int precision_bits_,
+                    bool allow_negative_ = false)
+        : unit(unit_),
+          max_value(max_value_),
+          precision_bits(precision_bits_),
+          allow_negative(allow_negative_) {}
+};
+
+// ============================================================================
+// LOG-LINEAR HISTOGRAM
+// ============================================================================
+
+class LogLinearHistogram {
+private:
+    HistogramConfig config;
+    uint64_t sub_bucket_count = 0;   // 2^precision_bits
+    uint64_t sub_bucket_half = 0;    // 2^(precision_bits-1)
+    uint64_t max_magnitude = 0;
+
+    std::vector<uint64_t> counts;           // magnitudes of values >= 0
+    std::vector<uint64_t> negative_counts;  // magnitudes of values < 0
+
+    uint64_t total_count = 0;
+    double sum = 0.0;
+    double min_value = 0.0;
+    double max_value = 0.0;
+
+public:
+    explicit LogLinearHistogram(const HistogramConfig& cfg = HistogramConfig()) {
+        configure(cfg);
+    }
+
+    // O(1): quantize, locate bucket, increment
+    void record(double value, uint64_t count = 1) {
+        if (count == 0 || std::isnan(value)) return;
+
+        bool negative = value < 0.0 && config.allow_negative;
+        double magnitude = negative ? -value : std::max(value, 0.0);
+        double scaled = magnitude / config.unit + 0.5;
+        uint64_t m = scaled >= static_cast<double>(max_magnitude)
+                         ? max_magnitude
+                         : static_cast<uint64_t>(scaled);
+
+        size_t idx = bucketIndex(m);
+        if (negative) {
+            negative_counts[idx] += count;
+        } else {
+            counts[idx] += count;
+        }
+
+        if (total_count == 0) {
+            min_value = value;
+            max_value = value;
+        } else {
+            min_value = std::min(min_value, value);
+            max_value = std::max(max_value, value);
+        }
+        total_count += count;
+        sum += value * static_cast<double>(count);
+    }
+
+    // Adds other's counts; fails if bucket layouts differ
+    bool merge(const LogLinearHistogram& other) {
+        if (!isCompatible(other)) return false;
+        if (other.total_count == 0) return true;
+
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        for (size_t i = 0; i < negative_counts.size(); ++i) {
+            negative_counts[i] += other.negative_counts[i];
+        }
+
+        if (total_count == 0) {
+            min_value = other.min_value;
+            max_value = other.max_value;
+        } else {
+            min_value = std::min(min_value, other.min_value);
+            max_value = std::max(max_value, other.max_value);
+        }
+        total_count += other.total_count;
+        sum += other.sum;
+        return true;
+    }
+
+    bool isCompatible(const LogLinearHistogram& other) const {
+        return config.unit == other.config.unit &&
+               config.precision_bits == other.config.precision_bits &&
+               config.allow_negative == other.config.allow_negative &&
+               counts.size() == other.counts.size();
+    }
+
+    // Copies state from a compatible histogram without reallocating
+    void copyFrom(const LogLinearHistogram& other) {
+        if (!isCompatible(other)) {
+            *this = other;
+            return;
+        }
+        std::memcpy(counts.data(), other.counts.data(),
+                    counts.size() * sizeof(uint64_t));
+        if (!negative_counts.empty()) {
+            std::memcpy(negative_counts.data(), other.negative_counts.data(),
+                        negative_counts.size() * sizeof(uint64_t));
+        }
+        total_count = other.total_count;
+        sum = other.sum;
+        min_value = other.min_value;
+        max_value = other.max_value;
+    }
+
+    // Value at the given percentile (0-100), within the configured precision
+    double percentile(double p) const {
+        if (total_count == 0) return 0.0;
+
+        p = std::min(std::max(p, 0.0), 100.0);
+        uint64_t rank = static_cast<uint64_t>(
+            std::ceil(p / 100.0 * static_cast<double>(total_count)));
+        rank = std::min(std::max<uint64_t>(rank, 1), total_count);
+
+        uint64_t seen = 0;
+        for (size_t i = negative_counts.size(); i-- > 0;) {
+            seen += negative_counts[i];
+            if (seen >= rank) return clampToRange(-representativeValue(i));
+        }
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) return clampToRange(representativeValue(i));
+        }
+        return max_value;
+    }
+
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        std::fill(negative_counts.begin(), negative_counts.end(), 0);
+        total_count = 0;
+        sum = 0.0;
+        min_value = 0.0;
+        max_value = 0.0;
+    }
+
+    uint64_t getTotalCount() const { return total_count; }
+    double getMin() const { return min_value; }
+    double getMax() const { return max_value; }
+    double getSum() const { return sum; }
+    double getMean() const {
+        return total_count > 0 ? sum / static_cast<double>(total_count) : 0.0;
+    }
+    size_t getBucketCount() const { return counts.size() + negative_counts.size(); }
+    const HistogramConfig& getConfig() const { return config; }
+
+    // ========================================================================
+    // CROSS-PROCESS EXCHANGE
+    // ========================================================================
+    //
+    // Compact little-endian encoding: configuration, summary values, then
+    // (index, count) pairs for non-empty buckets only.
+
+    std::vector<uint8_t> encode() const {
+        std::vector<uint8_t> out;
+        out.reserve(64 + 12 * nonEmptyBuckets());
+        putU32(out, ENCODING_MAGIC);
+        putU32(out, static_cast<uint32_t>(config.precision_bits));
+        putU32(out, config.allow_negative ? 1u : 0u);
+        putF64(out, config.unit);
+        putF64(out, config.max_value);
+        putU64(out, total_count);
+        putF64(out, sum);
+        putF64(out, min_value);
+        putF64(out, max_value);
+
+        putU32(out, static_cast<uint32_t>(nonEmptyBuckets()));
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i] == 0) continue;
+            putU32(out, static_cast<uint32_t>(i));
+            putU64(out, counts[i]);
+        }
+        for (size_t i = 0; i < negative_counts.size(); ++i) {
+            if (negative_counts[i] == 0) continue;
+            putU32(out, static_cast<uint32_t>(i | NEGATIVE_INDEX_FLAG));
+            putU64(out, negative_counts[i]);
+        }
+        return out;
+    }
+
+    static bool decode(const uint8_t* data, size_t size, LogLinearHistogram& out) {
+        size_t pos = 0;
+        uint32_t magic, bits, negative, entries;
+        HistogramConfig cfg;
+        uint64_t total;
+        double s, lo, hi;
+
+        if (!getU32(data, size, pos, magic) || magic != ENCODING_MAGIC) return false;
+        if (!getU32(data, size, pos, bits) || !getU32(data, size, pos, negative) ||
+            !getF64(data, size, pos, cfg.unit) || !getF64(data, size, pos, cfg.max_value) ||
+            !getU64(data, size, pos, total) || !getF64(data, size, pos, s) ||
+            !getF64(data, size, pos, lo) || !getF64(data, size, pos, hi) ||
+            !getU32(data, size, pos, entries)) {
+            return false;
+        }
+        if (bits < 1 || bits > 20 || !(cfg.unit > 0.0) || !(cfg.max_value > 0.0)) {
+            return false;
+        }
+        cfg.precision_bits = static_cast<int>(bits);
+        cfg.allow_negative = negative != 0;
+
+        LogLinearHistogram h(cfg);
+        for (uint32_t e = 0; e < entries; ++e) {
+            uint32_t idx;
+            uint64_t c;
+            if (!getU32(data, size, pos, idx) || !getU64(data, size, pos, c)) return false;
+            bool neg = (idx & NEGATIVE_INDEX_FLAG) != 0;
+            idx &= ~NEGATIVE_INDEX_FLAG;
+            std::vector<uint64_t>& target = neg ? h.negative_counts : h.counts;
+            if (idx >= target.size()) return false;
+            target[idx] += c;
+        }
+        h.total_count = total;
+        h.sum = s;
+        h.min_value = lo;
+        h.max_value = hi;
+        out = std::move(h);
+        return true;
+    }
+
+private:
+    static constexpr uint32_t ENCODING_MAGIC = 0x31474841u; // "AHG1"
+    static constexpr uint32_t NEGATIVE_INDEX_FLAG = 0x80000000u;
+
+    void configure(const HistogramConfig& cfg) {
+        config = cfg;
+        config.precision_bits = std::min(std::max(config.precision_bits, 1), 20);
+        if (!(config.unit > 0.0)) config.unit = 1.0;
+        if (!(config.max_value >= config.unit)) config.max_value = config.unit;
+
+        sub_bucket_count = uint64_t(1) << config.precision_bits;
+        sub_bucket_half = sub_bucket_count >> 1;
+        double max_m = std::ceil(config.max_value / config.unit);
+        max_magnitude = max_m >= 9.0e18 ? uint64_t(9000000000000000000ULL)
+                                        : static_cast<uint64_t>(max_m);
+
+        counts.assign(bucketIndex(max_magnitude) + 1, 0);
+        negative_counts.assign(config.allow_negative ? counts.size() : 0, 0);
+    }
+
+    static int highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(v);
+#else
+        int bit = 0;
+        while (v >>= 1) ++bit;
+        return bit;
+#endif
+    }
+
+    // Exact below sub_bucket_count; above, sub_bucket_half linear steps per
+    // power of two, laid out contiguously.
+    size_t bucketIndex(uint64_t m) const {
+        if (m < sub_bucket_count) return static_cast<size_t>(m);
+        int shift = highestBit(m) - (config.precision_bits - 1);
+        return static_cast<size_t>(shift * sub_bucket_half + (m >> shift));
+    }
+
+    // Midpoint of the bucket's magnitude range, in value units
+    double representativeValue(size_t idx) const {
+        if (idx < sub_bucket_count) return static_cast<double>(idx) * config.unit;
+        uint64_t shift = idx / sub_bucket_half - 1;
+        uint64_t sub = idx - shift * sub_bucket_half;
+        double lower = static_cast<double>(sub << shift);
+        double width = static_cast<double>(uint64_t(1) << shift);
+        return (lower + (width - 1.0) / 2.0) * config.unit;
+    }
+
+    double clampToRange(double v) const {
+        return std::min(std::max(v, min_value), max_value);
+    }
+
+    size_t nonEmptyBuckets() const {
+        size_t n = 0;
+        for (uint64_t c : counts) n += (c != 0);
+        for (uint64_t c : negative_counts) n += (c != 0);
+        return n;
+    }
+
+    static void putU32(std::vector<uint8_t>& out, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    static void putU64(std::vector<uint8_t>& out, uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    static void putF64(std::vector<uint8_t>& out, double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        putU64(out, bits);
+    }
+    static bool getU32(const uint8_t* d, size_t size, size_t& pos, uint32_t& v) {
+        if (pos > size || size - pos < 4) return false;
+        v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(d[pos + i]) << (8 * i);
+        pos += 4;
+        return true;
+    }
+    static bool getU64(const uint8_t* d, size_t size, size_t& pos, uint64_t& v) {
+        if (pos > size || size - pos < 8) return false;
+        v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(d[pos + i]) << (8 * i);
+        pos += 8;
+        return true;
+    }
+    static bool getF64(const uint8_t* d, size_t size, size_t& pos, double& v) {
+        uint64_t bits;
+        if (!getU64(d, size, pos, bits)) return false;
+        std::memcpy(&v, &bits, sizeof(v));
+        return true;
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_HISTOGRAM_HPP
@@ -0,0 +1,381 @@
+/*
+ * AILLE Metrics Extension - Labeled Metric Families
+ * Per-symbol / per-strategy metrics in one bounded table
+ *
+ * License: MIT (see LICENSE)
+ *
+ * One MetricsCollector per symbol costs a mutex and tens of KB each.
+ * A LabeledMetrics family instead keeps compact per-label counters in a
+ * flat open-addressing table keyed by interned label IDs:
+ *
+ *   - LabelRegistry interns "AAPL" / "momentum_v2" to dense uint32 IDs
+ *     once, off the hot path
+ *   - observeDecision(id, decision) is a lock-free hash probe plus a few
+ *     increments under one of LOCK_STRIPES locks, each guarding a
+ *     contiguous slot range, so threads on different labels rarely contend
+ *   - cardinality is bounded: labels beyond max_labels are folded into a
+ *     single "other" entry instead of growing the table
+ *   - per-label lookups are O(1); top-N queries are O(capacity)
+ */
+
+#ifndef AILLE_LABELED_METRICS_HPP
+#define AILLE_LABELED_METRICS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// LABEL INTERNING
+// ============================================================================
+
+class LabelRegistry {
+private:
+    mutable std::mutex mtx;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names;
+
+public:
+    static constexpr uint32_t INVALID_LABEL = UINT32_MAX;
+
+    // Returns the existing ID or assigns the next dense one
+    uint32_t intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(names.size());
+        ids.emplace(name, id);
+        names.push_back(name);
+        return id;
+    }
+
+    uint32_t find(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : INVALID_LABEL;
+    }
+
+    std::string name(uint32_t id) const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return id < names.size() ? names[id] : std::string("other");
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx);
+        return names.size();
+    }
+};
+
+// ============================================================================
+// PER-LABEL STATISTICS (TRIVIALLY COPYABLE)
+// ============================================================================
+
+struct LabelStats {
+    uint32_t label_id = LabelRegistry::INVALID_LABEL;
+    uint64_t total_decisions = 0;
+    uint64_t valid_decisions = 0;
+    uint64_t fallback_activations = 0;
+    uint64_t rejected_confidence = 0;
+    uint64_t rejected_consensus = 0;
+    uint64_t invalid_inputs = 0;
+    double confidence_sum = 0.0;
+    float min_confidence = 0.0f;
+    float max_confidence = 0.0f;
+    uint64_t last_decision_timestamp_ns = 0;
+
+    float fallbackRate() const {
+        return total_decisions ? static_cast<float>(fallback_activations) / total_decisions : 0.0f;
+    }
+    float consensusFailureRate() const {
+        return total_decisions ? static_cast<float>(rejected_consensus) / total_decisions : 0.0f;
+    }
+    float averageConfidence() const {
+        return total_decisions ? static_cast<float>(confidence_sum / total_decisions) : 0.0f;
+    }
+};
+
+enum LabelRanking {
+    RANK_BY_DECISIONS,
+    RANK_BY_FALLBACKS,
+    RANK_BY_FALLBACK_RATE,
+    RANK_BY_CONSENSUS_FAILURE_RATE,
+    RANK_BY_LOW_CONFIDENCE
+};
+
+// Widen to a MetricsSnapshot, e.g. for formatMetrics()
+inline MetricsSnapshot toMetricsSnapshot(const LabelStats& s) {
+    MetricsSnapshot out;
+    out.total_decisions = s.total_decisions;
+    out.valid_decisions = s.valid_decisions;
+    out.fallback_activations = s.fallback_activations;
+    out.rejected_confidence = s.rejected_confidence;
+    out.rejected_consensus = s.rejected_consensus;
+    out.invalid_inputs = s.invalid_inputs;
+    out.average_confidence = s.averageConfidence();
+    out.fallback_rate = s.fallbackRate();
+    out.consensus_failure_rate = s.consensusFailureRate();
+    out.min_confidence = s.min_confidence;
+    out.max_confidence = s.max_confidence;
+    out.last_decision_timestamp_ns = s.last_decision_timestamp_ns;
+    return out;
+}
+
+// ============================================================================
+// LABELED METRIC FAMILY (FLAT OPEN ADDRESSING, BOUNDED CARDINALITY)
+// ============================================================================
+
+class LabeledMetrics {
+public:
+    static constexpr size_t DEFAULT_MAX_LABELS = 4096;
+    static constexpr size_t LOCK_STRIPES = 64;
+
+private:
+    static constexpr uint32_t EMPTY_SLOT = LabelRegistry::INVALID_LABEL;
+
+    // One lock per contiguous slot range, padded against false sharing
+    struct alignas(64) Stripe {
+        std::mutex mtx;
+    };
+
+    size_t max_labels;
+    std::atomic<size_t> label_count{0};
+    std::atomic<uint64_t> resets{0};      // bumped by reset() under every stripe lock
+    size_t mask;
+    int hash_shift;
+    int stripe_shift;                // slot >> stripe_shift = stripe index
+    size_t stripe_count;
+    // Keys are claimed once (EMPTY -> id) under the slot's stripe lock and
+    // only cleared by reset(), so probes read them without locking
+    std::unique_ptr<std::atomic<uint32_t>[]> keys;
+    std::vector<LabelStats> slots;   // guarded by the slot's stripe
+    std::unique_ptr<Stripe[]> stripes;
+    mutable std::mutex other_mtx;
+    LabelStats other;                // labels beyond max_labels
+
+public:
+    explicit LabeledMetrics(size_t max_labels_ = DEFAULT_MAX_LABELS)
+        : max_labels(std::max<size_t>(1, max_labels_)) {
+        // Power-of-two capacity at <= 50% load keeps probe chains short
+        size_t capacity = 2;
+        int bits = 1;
+        while (capacity < 2 * max_labels) {
+            capacity <<= 1;
+            ++bits;
+        }
+        mask = capacity - 1;
+        hash_shift = 64 - bits;
+
+        stripe_count = std::min(capacity, LOCK_STRIPES);
+        stripe_shift = 0;
+        while ((capacity >> stripe_shift) > stripe_count) ++stripe_shift;
+
+        keys.reset(new std::atomic<uint32_t>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) keys[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+        slots.resize(capacity);
+        stripes.reset(new Stripe[stripe_count]);
+    }
+
+    void observeDecision(uint32_t label_id, const Decision& d) {
+        if (label_id != EMPTY_SLOT) {
+            size_t slot = mask + 1;
+            std::unique_lock<std::mutex> lock = lockSlotFor(label_id, slot);
+            if (lock.owns_lock()) {
+                record(slots[slot], d);
+                return;
+            }
+        }
+        std::lock_guard<std::mutex> lock(other_mtx);
+        record(other, d);
+    }
+
+    // O(1) lookup; false if the label was never seen (or went to "other")
+    bool getLabelStats(uint32_t label_id, LabelStats& out) const {
+        if (label_id == EMPTY_SLOT) return false;
+        size_t slot = findSlot(label_id);
+        if (keys[slot].load(std::memory_order_acquire) != label_id) return false;
+        std::lock_guard<std::mutex> lock(stripeFor(slot));
+        // reset() may have cleared the slot before the lock was taken
+        if (keys[slot].load(std::memory_order_relaxed) != label_id) return false;
+        out = slots[slot];
+        return true;
+    }
+
+    LabelStats getOtherStats() const {
+        std::lock_guard<std::mutex> lock(other_mtx);
+        return other;
+    }
+
+    // Top-N labels by the given ranking (worst first for rate rankings).
+    // Slots are copied one stripe at a time (each stripe is consistent,
+    // the table as a whole is not a single instant) and ranked after the
+    // locks are released.
+    std::vector<LabelStats> topN(size_t n, LabelRanking by = RANK_BY_DECISIONS) const {
+        std::vector<LabelStats> all;
+        all.reserve(label_count.load(std::memory_order_relaxed));
+        size_t per_stripe = size_t(1) << stripe_shift;
+        for (size_t st = 0; st < stripe_count; ++st) {
+            std::lock_guard<std::mutex> lock(stripes[st].mtx);
+            for (size_t i = st * per_stripe; i < (st + 1) * per_stripe; ++i) {
+                if (keys[i].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+                    all.push_back(slots[i]);
+                }
+            }
+        }
+
+        auto before = [by](const LabelStats& a, const LabelStats& b) {
+            switch (by) {
+                case RANK_BY_FALLBACKS:
+                    return a.fallback_activations > b.fallback_activations;
+                case RANK_BY_FALLBACK_RATE:
+                    return a.fallbackRate() > b.fallbackRate();
+                case RANK_BY_CONSENSUS_FAILURE_RATE:
+                    return a.consensusFailureRate() > b.consensusFailureRate();
+                case RANK_BY_LOW_CONFIDENCE:
+                    return a.averageConfidence() < b.averageConfidence();
+                case RANK_BY_DECISIONS:
+                default:
+                    return a.total_decisions > b.total_decisions;
+            }
+        };
+
+        n = std::min(n, all.size());
+        std::partial_sort(all.begin(), all.begin() + n, all.end(), before);
+        all.resize(n);
+        return all;
+    }
+
+    size_t getLabelCount() const { return label_count.load(std::memory_order_relaxed); }
+
+    size_t getMaxLabels() const { return max_labels; }
+
+    size_t getLockStripes() const { return stripe_count; }
+
+    // Takes every stripe lock (in order) and the "other" lock
+    void reset() {
+        std::vector<std::unique_lock<std::mutex>> held;
+        held.reserve(stripe_count);
+        for (size_t st = 0; st < stripe_count; ++st) held.emplace_back(stripes[st].mtx);
+        std::lock_guard<std::mutex> lock(other_mtx);
+        for (size_t i = 0; i <= mask; ++i) keys[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+        std::fill(slots.begin(), slots.end(), LabelStats());
+        other = LabelStats();
+        label_count.store(0, std::memory_order_relaxed);
+        resets.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    // Fibonacci hashing spreads dense interned IDs across the table
+    size_t home(uint32_t label_id) const {
+        return static_cast<size_t>(
+            (static_cast<uint64_t>(label_id) * 0x9E3779B97F4A7C15ULL) >> hash_shift);
+    }
+
+    std::mutex& stripeFor(size_t slot) const { return stripes[slot >> stripe_shift].mtx; }
+
+    // Linear probe to the label's slot or the first empty one
+    size_t findSlot(uint32_t label_id) const {
+        size_t i = home(label_id) & mask;
+        while (true) {
+            uint32_t key = keys[i].load(std::memory_order_acquire);
+            if (key == EMPTY_SLOT || key == label_id) return i;
+            i = (i + 1) & mask;
+        }
+    }
+
+    // Locks the stripe of the label's slot, claiming an empty slot if the
+    // label is new. Returns an unlocked lock if the table is full (the
+    // caller falls back to "other").
+    std::unique_lock<std::mutex> lockSlotFor(uint32_t label_id, size_t& slot) {
+        uint64_t epoch = resets.load(std::memory_order_acquire);
+        size_t i = home(label_id) & mask;
+        while (true) {
+            uint32_t key = keys[i].load(std::memory_order_acquire);
+            if (key != EMPTY_SLOT && key != label_id) {
+                i = (i + 1) & mask;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(stripeFor(i));
+            key = keys[i].load(std::memory_order_relaxed);
+            if (key == label_id) {
+                slot = i;
+                return lock;
+            }
+            if (key != EMPTY_SLOT) {
+                // Another label claimed it between the probe and the lock
+                lock.unlock();
+                i = (i + 1) & mask;
+                continue;
+            }
+            if (resets.load(std::memory_order_relaxed) != epoch) {
+                // reset() emptied slots this probe already passed
+                lock.unlock();
+                epoch = resets.load(std::memory_order_acquire);
+                i = home(label_id) & mask;
+                continue;
+            }
+
+            // Claim it, unless the family is at max_labels
+            if (label_count.fetch_add(1, std::memory_order_relaxed) >= max_labels) {
+                label_count.fetch_sub(1, std::memory_order_relaxed);
+                return std::unique_lock<std::mutex>();
+            }
+            slots[i] = LabelStats();
+            slots[i].label_id = label_id;
+            keys[i].store(label_id, std::memory_order_release);
+            slot = i;
+            return lock;
+        }
+    }
+
+    static void record(LabelStats& s, const Decision& d) {
+        if (!isObservableDecision(d)) {
+            s.invalid_inputs++;
+            return;
+        }
+
+        if (s.total_decisions == 0) {
+            s.min_confidence = d.confidence;
+            s.max_confidence = d.confidence;
+        } else {
+            s.min_confidence = std::min(s.min_confidence, d.confidence);
+            s.max_confidence = std::max(s.max_confidence, d.confidence);
+        }
+        s.total_decisions++;
+        s.confidence_sum += d.confidence;
+        s.last_decision_timestamp_ns = d.timestamp_ns;
+
+        switch (d.status) {
+            case DECISION_VALID:
+                s.valid_decisions++;
+                break;
+            case REJECTED_LOW_CONFIDENCE:
+                s.rejected_confidence++;
+                s.fallback_activations++;
+                break;
+            case REJECTED_NO_CONSENSUS:
+                s.rejected_consensus++;
+                s.fallback_activations++;
+                break;
+            case FALLBACK_ACTIVATED:
+                s.fallback_activations++;
+                break;
+            default:
+                break;
+        }
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_LABELED_METRICS_HPP
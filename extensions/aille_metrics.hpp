@@ -14,238 +14,2069 @@
 #define AILLE_METRICS_HPP
 
 #include <cstdint>
-#include <unordered_map>
+#include <cstring>
 #include <vector>
+#include <deque>
+#include <utility>
+#include <memory>
 #include <string>
 #include <chrono>
-#include <numeric>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <atomic>
 #include <algorithm>
 #include <cmath>
+#include <type_traits>
 
 #include "aille.hpp"
+#include "aille_histogram.hpp"
+#include "aille_quantile_sketch.hpp"
+
+// Upper bound on models_agreed tracked per bucket; larger counts land in
+// the overflow bucket. Override before including to match your ensemble.
+#ifndef AILLE_METRICS_MAX_MODELS
+#define AILLE_METRICS_MAX_MODELS 64
+#endif
 
 namespace AILLE {
 
-// ============================================================================
-// METRICS SNAPSHOT
-// ============================================================================
+// ============================================================================
+// MODELS AGREED HISTOGRAM (FIXED SIZE, TRIVIALLY COPYABLE)
+// ============================================================================
+
+struct ModelsAgreedHistogram {
+    static constexpr int MAX_MODELS = AILLE_METRICS_MAX_MODELS;
+
+    uint64_t buckets[MAX_MODELS + 1] = {};  // index = models_agreed
+    uint64_t overflow = 0;                  // models_agreed > MAX_MODELS
+
+    void record(int models_agreed) {
+        if (models_agreed >= 0 && models_agreed <= MAX_MODELS) {
+            buckets[models_agreed]++;
+        } else {
+            overflow++;
+        }
+    }
+
+    uint64_t count(int models_agreed) const {
+        if (models_agreed < 0) return 0;
+        return models_agreed <= MAX_MODELS ? buckets[models_agreed] : overflow;
+    }
+
+    // Read access compatible with the former map-based histogram
+    uint64_t operator[](int models_agreed) const { return count(models_agreed); }
+
+    uint64_t total() const {
+        uint64_t sum = overflow;
+        for (uint64_t b : buckets) sum += b;
+        return sum;
+    }
+};
+
+// ============================================================================
+// FALLBACK REGIMES (RUN LENGTHS, TRIVIALLY COPYABLE)
+// ============================================================================
+//
+// How long the engine stays in fallback once it gets there, not just how
+// often. A streak is a maximal run of consecutive fallback (or normal)
+// decisions; completed streaks land in log2 length buckets, and the time
+// between consecutive decisions (Decision::timestamp_ns) is charged to the
+// state that was in effect. O(1) per decision.
+
+struct FallbackRegimes {
+    static constexpr int STREAK_BUCKETS = 32;   // bucket i: lengths [2^i, 2^(i+1))
+
+    bool in_fallback = false;                   // state of the current streak
+    uint64_t current_streak = 0;                // decisions in the current streak
+    uint64_t current_streak_ns = 0;             // time charged to the current streak
+    uint64_t longest_fallback_streak = 0;       // includes the current streak
+    uint64_t longest_normal_streak = 0;
+    uint64_t fallback_episodes = 0;             // fallback streaks started
+    uint64_t fallback_streak_log2[STREAK_BUCKETS] = {};  // completed streaks only
+    uint64_t normal_streak_log2[STREAK_BUCKETS] = {};
+    uint64_t time_in_fallback_ns = 0;
+    uint64_t time_in_normal_ns = 0;
+    uint64_t last_timestamp_ns = 0;             // 0: the next gap is not charged
+
+    // A gap between decisions longer than max_gap_ns (an idle period,
+    // downtime) is charged as max_gap_ns; 0 charges every gap in full
+    void record(bool fallback, uint64_t timestamp_ns, uint64_t max_gap_ns = 0) {
+        // Out-of-order timestamps are counted but not charged any time
+        if (timestamp_ns > last_timestamp_ns) {
+            if (current_streak > 0 && last_timestamp_ns != 0) {
+                uint64_t gap = timestamp_ns - last_timestamp_ns;
+                if (max_gap_ns > 0 && gap > max_gap_ns) gap = max_gap_ns;
+                (in_fallback ? time_in_fallback_ns : time_in_normal_ns) += gap;
+                current_streak_ns += gap;
+            }
+            last_timestamp_ns = timestamp_ns;
+        }
+
+        if (current_streak == 0 || fallback != in_fallback) {
+            if (current_streak > 0) {
+                uint64_t* buckets = in_fallback ? fallback_streak_log2 : normal_streak_log2;
+                buckets[bucketFor(current_streak)]++;
+            }
+            in_fallback = fallback;
+            current_streak = 0;
+            current_streak_ns = 0;
+            if (fallback) fallback_episodes++;
+        }
+
+        ++current_streak;
+        uint64_t& longest = fallback ? longest_fallback_streak : longest_normal_streak;
+        if (current_streak > longest) longest = current_streak;
+    }
+
+    // After a checkpoint restore: the current streak continues, but the
+    // time between the checkpoint and the next decision is not charged
+    void resume() { last_timestamp_ns = 0; }
+
+    // Time charged to the current streak so far
+    uint64_t currentStreakNs() const { return current_streak > 0 ? current_streak_ns : 0; }
+
+    float fallbackTimeFraction() const {
+        uint64_t total = time_in_fallback_ns + time_in_normal_ns;
+        return total ? static_cast<float>(time_in_fallback_ns) / total : 0.0f;
+    }
+
+    // Mean fallback streak length, including the current one
+    float meanFallbackStreak(uint64_t fallback_decisions) const {
+        return fallback_episodes ? static_cast<float>(fallback_decisions) / fallback_episodes
+                                 : 0.0f;
+    }
+
+    static int bucketFor(uint64_t length) {
+        int b = 0;
+        while (length > 1 && b < STREAK_BUCKETS - 1) {
+            length >>= 1;
+            ++b;
+        }
+        return b;
+    }
+};
+
+// ============================================================================
+// METRICS CONFIGURATION
+// ============================================================================
+
+struct MetricsConfig {
+    // Raw confidence window for average/min/max/stddev. 0 keeps no raw
+    // samples (~40 KB saved) and reports lifetime statistics instead.
+    size_t confidence_window;          // Default: 10000
+
+    // KLL sketch serving arbitrary confidence quantiles. 0 disables.
+    int quantile_sketch_k;             // Default: 200 (~2.5 KB, ~1.3% rank error)
+
+    // Distributions (confidence, final_value, decision latency). With the
+    // defaults a MetricsCollector holds ~7.8 KB inline plus ~60 KB heap
+    // (40 KB confidence window, ~19 KB histograms), and getSnapshot()
+    // allocates ~19 KB of histogram scratch (none via a reused Scratch).
+    bool enable_histograms;            // Default: true
+    int histogram_precision_bits;      // Default: 7 (<0.8% relative error)
+    double max_tracked_value;          // Default: 10.0 (|final_value| clamp)
+
+    // Latency histograms are coarser than the value histograms: a
+    // decision takes microseconds, so 10 ns steps and 5 bits (<3.2%
+    // relative error) up to 1 s need ~380 buckets (~3 KB).
+    double latency_resolution_ns;      // Default: 10
+    double max_tracked_latency_ns;     // Default: 1 s
+    int latency_precision_bits;        // Default: 5
+
+    // One more latency histogram per DecisionStatus (5 x ~3 KB heap,
+    // also copied by every getSnapshot()). Off: latency_ns_by_status
+    // stays empty.
+    bool latency_by_status;            // Default: false
+
+    // Time-bucketed rolling windows keyed by Decision::timestamp_ns.
+    // Horizon = buckets x bucket width; 3600 x 1 s covers 5m/30m/1h.
+    size_t rolling_window_buckets;     // Default: 0 (disabled, ~330 B per bucket)
+    uint64_t rolling_bucket_ns;        // Default: 1 s
+
+    // Sampled observation. Counters, the models-agreed histogram, rolling
+    // windows and latency stay exact; the confidence window, sketch,
+    // confidence/final_value histograms and derived statistics see 1 in N
+    // decisions (every Nth, or geometric random gaps with mean N).
+    uint32_t sample_every;             // Default: 1 (no sampling)
+    bool random_sampling;              // Default: false (deterministic)
+    uint64_t sampling_seed;            // Default: fixed, reproducible
+
+    // Longest gap between decisions charged to the fallback regime
+    // clocks (time_in_fallback_ns / time_in_normal_ns); longer idle
+    // periods count as this much. 0 charges every gap in full.
+    uint64_t max_regime_gap_ns;        // Default: 1 s
+
+    MetricsConfig()
+        : confidence_window(10000),
+          quantile_sketch_k(KllSketch::DEFAULT_K),
+          enable_histograms(true),
+          histogram_precision_bits(7),
+          max_tracked_value(10.0),
+          latency_resolution_ns(10.0),
+          max_tracked_latency_ns(1e9),
+          latency_precision_bits(5),
+          latency_by_status(false),
+          rolling_window_buckets(0),
+          rolling_bucket_ns(1000000000ULL),
+          sample_every(1),
+          random_sampling(false),
+          sampling_seed(0x9e3779b97f4a7c15ULL),
+          max_regime_gap_ns(1000000000ULL) {}
+};
+
+// ============================================================================
+// METRICS SNAPSHOT
+// ============================================================================
+
+constexpr int DECISION_STATUS_COUNT = static_cast<int>(ERROR_NO_MODELS) + 1;
+
+// Stable lowercase names, e.g. for metric labels
+inline const char* decisionStatusLabel(DecisionStatus s) {
+    switch (s) {
+        case DECISION_VALID: return "valid";
+        case REJECTED_LOW_CONFIDENCE: return "rejected_confidence";
+        case REJECTED_NO_CONSENSUS: return "rejected_consensus";
+        case FALLBACK_ACTIVATED: return "fallback";
+        case ERROR_NO_MODELS: return "no_models";
+        default: return "unknown";
+    }
+}
+
+struct PercentileSummary {
+    uint64_t count = 0;
+    double sum = 0.0;
+    float p50 = 0.0f;
+    float p90 = 0.0f;
+    float p99 = 0.0f;
+    float p999 = 0.0f;
+
+    void fillFrom(const LogLinearHistogram& h) {
+        count = h.getTotalCount();
+        sum = h.getSum();
+        p50 = static_cast<float>(h.percentile(50.0));
+        p90 = static_cast<float>(h.percentile(90.0));
+        p99 = static_cast<float>(h.percentile(99.0));
+        p999 = static_cast<float>(h.percentile(99.9));
+    }
+};
+
+struct MetricsSnapshot {
+    uint64_t total_decisions = 0;
+    uint64_t valid_decisions = 0;
+    uint64_t fallback_activations = 0;
+    uint64_t rejected_confidence = 0;
+    uint64_t rejected_consensus = 0;
+    uint64_t invalid_inputs = 0;
+
+    float average_confidence = 0.0f;
+    float fallback_rate = 0.0f;
+    float consensus_failure_rate = 0.0f;
+    float min_confidence = 0.0f;
+    float max_confidence = 0.0f;
+    float stddev_confidence = 0.0f;
+
+    ModelsAgreedHistogram models_agreed_histogram;
+    FallbackRegimes fallback_regimes;
+
+    // Filled by getSnapshot() from the distribution histograms
+    PercentileSummary confidence_percentiles;
+    PercentileSummary final_value_percentiles;
+    PercentileSummary latency_ns_percentiles;
+    PercentileSummary latency_ns_by_status[DECISION_STATUS_COUNT];
+
+    uint64_t last_decision_timestamp_ns = 0;
+    bool overflow_detected = false;
+
+    // Rolling-window snapshots only (0 = lifetime snapshot)
+    uint64_t window_ns = 0;
+    float decisions_per_second = 0.0f;
+
+    // Sampling (MetricsConfig::sample_every). Distribution counts/sums are
+    // scaled to total_decisions; error bounds are 95% half-widths and are
+    // 0 when every decision is sampled.
+    float sampling_rate = 1.0f;
+    uint64_t sampled_decisions = 0;
+    float average_confidence_error = 0.0f;   // on average_confidence
+    float confidence_rank_error = 0.0f;      // normalized rank, excl. sketch error
+};
+
+static_assert(std::is_trivially_copyable<MetricsSnapshot>::value,
+              "MetricsSnapshot must stay trivially copyable");
+
+// ============================================================================
+// INPUT VALIDATION (SHARED BY ALL COLLECTORS)
+// ============================================================================
+
+inline bool isObservableDecision(const Decision& d) {
+    // Validate confidence range
+    if (std::isnan(d.confidence) || std::isinf(d.confidence)) {
+        return false;
+    }
+    if (d.confidence < 0.0f || d.confidence > 1.0f) {
+        return false;
+    }
+
+    // Validate timestamp (basic sanity check)
+    if (d.timestamp_ns == 0) {
+        return false;
+    }
+
+    // Validate models_agreed is reasonable
+    if (d.models_agreed < 0) {
+        return false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// CHECKPOINT ENCODING (LITTLE-ENDIAN, BOUNDS-CHECKED)
+// ============================================================================
+
+class StateEncoder {
+private:
+    std::vector<uint8_t>& out;
+
+public:
+    explicit StateEncoder(std::vector<uint8_t>& buffer) : out(buffer) {}
+
+    void u32(uint32_t v) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void u64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+    }
+    void f32(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u32(bits);
+    }
+    void f64(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        u64(bits);
+    }
+    void bytes(const std::vector<uint8_t>& b) {
+        u64(b.size());
+        out.insert(out.end(), b.begin(), b.end());
+    }
+};
+
+// Every read fails once the input is exhausted; check ok() at the end
+class StateDecoder {
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+    bool good = true;
+
+public:
+    StateDecoder(const uint8_t* d, size_t n) : data(d), size(n) {}
+
+    bool ok() const { return good; }
+    size_t remaining() const { return good ? size - pos : 0; }
+
+    uint32_t u32() {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(data[pos + i]) << (8 * i);
+        pos += 4;
+        return v;
+    }
+    uint64_t u64() {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        pos += 8;
+        return v;
+    }
+    float f32() {
+        uint32_t bits = u32();
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    double f64() {
+        uint64_t bits = u64();
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    // Zero-copy view of a length-prefixed blob
+    const uint8_t* bytes(size_t& length) {
+        uint64_t n = u64();
+        if (!need(n)) return nullptr;
+        const uint8_t* p = data + pos;
+        pos += static_cast<size_t>(n);
+        length = static_cast<size_t>(n);
+        return p;
+    }
+    // Sanity bound for element counts read from untrusted input
+    bool fits(uint64_t count, size_t element_size) {
+        if (good && count <= (size - pos) / element_size) return true;
+        good = false;
+        return false;
+    }
+
+private:
+    bool need(uint64_t n) {
+        if (good && n <= size - pos) return true;
+        good = false;
+        return false;
+    }
+};
+
+// FNV-1a, guards checkpoints against truncation and bit rot
+inline uint64_t stateChecksum(const uint8_t* data, size_t size) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= data[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// ============================================================================
+// ROLLING TIME WINDOWS
+// ============================================================================
+//
+// A ring of fixed-width time buckets. Each bucket holds mergeable
+// aggregates (counts, confidence sums, extremes and a 64-bin confidence
+// histogram), so any window up to the horizon is answered by merging the
+// buckets it covers - O(buckets), never a rescan of decisions.
+
+class RollingWindowMetrics {
+public:
+    static constexpr int CONFIDENCE_BINS = 64;
+
+private:
+    static constexpr uint64_t EMPTY_EPOCH = UINT64_MAX;
+
+    struct Bucket {
+        uint64_t epoch = EMPTY_EPOCH;   // timestamp_ns / bucket width
+        uint64_t total_decisions = 0;
+        uint64_t valid_decisions = 0;
+        uint64_t fallback_activations = 0;
+        uint64_t rejected_confidence = 0;
+        uint64_t rejected_consensus = 0;
+        uint64_t invalid_inputs = 0;
+        double confidence_sum = 0.0;
+        double confidence_sum_sq = 0.0;
+        float min_confidence = 1.0f;
+        float max_confidence = 0.0f;
+        uint32_t confidence_bins[CONFIDENCE_BINS] = {};
+    };
+
+    std::vector<Bucket> buckets;
+    uint64_t bucket_ns;
+    uint64_t latest_epoch = 0;
+
+public:
+    // Live buckets of one window, copied by copyWindow() so the owner's
+    // lock covers only the copy; reuse one to avoid reallocating
+    class WindowCopy {
+    private:
+        friend class RollingWindowMetrics;
+        std::vector<Bucket> buckets;
+        uint64_t window_ns = 0;
+    };
+
+    RollingWindowMetrics(size_t bucket_count, uint64_t bucket_width_ns)
+        : buckets(bucket_count), bucket_ns(std::max<uint64_t>(1, bucket_width_ns)) {}
+
+    bool enabled() const { return !buckets.empty(); }
+    uint64_t horizonNs() const { return buckets.size() * bucket_ns; }
+
+    void observe(const Decision& d, bool valid) {
+        if (buckets.empty()) return;
+
+        // Invalid decisions may carry a bogus timestamp; file them "now"
+        uint64_t epoch = valid ? d.timestamp_ns / bucket_ns : latest_epoch;
+        Bucket* b = bucketFor(epoch);
+        if (b == nullptr) return;  // older than the horizon
+
+        if (!valid) {
+            b->invalid_inputs++;
+            return;
+        }
+
+        b->total_decisions++;
+        switch (d.status) {
+            case DECISION_VALID:
+                b->valid_decisions++;
+                break;
+            case REJECTED_LOW_CONFIDENCE:
+                b->rejected_confidence++;
+                b->fallback_activations++;
+                break;
+            case REJECTED_NO_CONSENSUS:
+                b->rejected_consensus++;
+                b->fallback_activations++;
+                break;
+            case FALLBACK_ACTIVATED:
+                b->fallback_activations++;
+                break;
+            default:
+                break;
+        }
+
+        float c = d.confidence;
+        b->confidence_sum += c;
+        b->confidence_sum_sq += static_cast<double>(c) * c;
+        b->min_confidence = std::min(b->min_confidence, c);
+        b->max_confidence = std::max(b->max_confidence, c);
+        int bin = std::min(static_cast<int>(c * CONFIDENCE_BINS), CONFIDENCE_BINS - 1);
+        b->confidence_bins[bin]++;
+    }
+
+    // Copies the buckets covering (now_ns - window_ns, now_ns] into out.
+    // Windows longer than the horizon are truncated to it.
+    void copyWindow(uint64_t window_ns, uint64_t now_ns, WindowCopy& out) const {
+        out.buckets.clear();
+        out.window_ns = std::min(window_ns, horizonNs());
+        if (buckets.empty() || out.window_ns == 0) return;
+
+        uint64_t end_epoch = now_ns / bucket_ns;
+        uint64_t span = std::max<uint64_t>(1, out.window_ns / bucket_ns);
+        uint64_t start_epoch = end_epoch >= span - 1 ? end_epoch - (span - 1) : 0;
+
+        for (uint64_t e = start_epoch; e <= end_epoch; ++e) {
+            const Bucket& b = buckets[e % buckets.size()];
+            if (b.epoch == e) out.buckets.push_back(b);
+        }
+    }
+
+    // Merges a copied window into out; needs no lock
+    static void aggregate(const WindowCopy& window, MetricsSnapshot& out) {
+        out.window_ns = window.window_ns;
+        if (out.window_ns == 0) return;
+
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        float lo = 1.0f;
+        float hi = 0.0f;
+        uint64_t bins[CONFIDENCE_BINS] = {};
+
+        for (const Bucket& b : window.buckets) {
+            out.total_decisions += b.total_decisions;
+            out.valid_decisions += b.valid_decisions;
+            out.fallback_activations += b.fallback_activations;
+            out.rejected_confidence += b.rejected_confidence;
+            out.rejected_consensus += b.rejected_consensus;
+            out.invalid_inputs += b.invalid_inputs;
+            sum += b.confidence_sum;
+            sum_sq += b.confidence_sum_sq;
+            lo = std::min(lo, b.min_confidence);
+            hi = std::max(hi, b.max_confidence);
+            for (int i = 0; i < CONFIDENCE_BINS; ++i) bins[i] += b.confidence_bins[i];
+        }
+
+        if (out.total_decisions == 0) return;
+
+        double n = static_cast<double>(out.total_decisions);
+        out.fallback_rate = static_cast<float>(out.fallback_activations / n);
+        out.consensus_failure_rate = static_cast<float>(out.rejected_consensus / n);
+        out.decisions_per_second = static_cast<float>(n * 1e9 / out.window_ns);
+
+        double mean = sum / n;
+        out.average_confidence = static_cast<float>(mean);
+        out.stddev_confidence =
+            static_cast<float>(std::sqrt(std::max(sum_sq / n - mean * mean, 0.0)));
+        out.min_confidence = lo;
+        out.max_confidence = hi;
+
+        PercentileSummary& p = out.confidence_percentiles;
+        p.count = out.total_decisions;
+        p.p50 = binPercentile(bins, out.total_decisions, 0.50, lo, hi);
+        p.p90 = binPercentile(bins, out.total_decisions, 0.90, lo, hi);
+        p.p99 = binPercentile(bins, out.total_decisions, 0.99, lo, hi);
+        p.p999 = binPercentile(bins, out.total_decisions, 0.999, lo, hi);
+    }
+
+    void reset() {
+        for (auto& b : buckets) b = Bucket();
+        latest_epoch = 0;
+    }
+
+    void encodeState(StateEncoder& enc) const {
+        enc.u64(buckets.size());
+        enc.u64(bucket_ns);
+        enc.u64(latest_epoch);
+        for (const Bucket& b : buckets) {
+            enc.u64(b.epoch);
+            enc.u64(b.total_decisions);
+            enc.u64(b.valid_decisions);
+            enc.u64(b.fallback_activations);
+            enc.u64(b.rejected_confidence);
+            enc.u64(b.rejected_consensus);
+            enc.u64(b.invalid_inputs);
+            enc.f64(b.confidence_sum);
+            enc.f64(b.confidence_sum_sq);
+            enc.f32(b.min_confidence);
+            enc.f32(b.max_confidence);
+            for (uint32_t c : b.confidence_bins) enc.u32(c);
+        }
+    }
+
+    // Decodes into `out` (same layout required); false leaves it untouched
+    bool decodeState(StateDecoder& dec, RollingWindowMetrics& out) const {
+        if (dec.u64() != buckets.size() || dec.u64() != bucket_ns) return false;
+        RollingWindowMetrics tmp(buckets.size(), bucket_ns);
+        tmp.latest_epoch = dec.u64();
+        for (Bucket& b : tmp.buckets) {
+            b.epoch = dec.u64();
+            b.total_decisions = dec.u64();
+            b.valid_decisions = dec.u64();
+            b.fallback_activations = dec.u64();
+            b.rejected_confidence = dec.u64();
+            b.rejected_consensus = dec.u64();
+            b.invalid_inputs = dec.u64();
+            b.confidence_sum = dec.f64();
+            b.confidence_sum_sq = dec.f64();
+            b.min_confidence = dec.f32();
+            b.max_confidence = dec.f32();
+            for (uint32_t& c : b.confidence_bins) c = dec.u32();
+        }
+        if (!dec.ok()) return false;
+        out = std::move(tmp);
+        return true;
+    }
+
+private:
+    Bucket* bucketFor(uint64_t epoch) {
+        if (epoch + buckets.size() <= latest_epoch) return nullptr;
+        latest_epoch = std::max(latest_epoch, epoch);
+
+        Bucket& b = buckets[epoch % buckets.size()];
+        if (b.epoch != epoch) {
+            if (b.epoch != EMPTY_EPOCH && b.epoch > epoch) return nullptr;
+            b = Bucket();
+            b.epoch = epoch;
+        }
+        return &b;
+    }
+
+    // Linear interpolation inside the bin holding the target rank
+    static float binPercentile(const uint64_t* bins, uint64_t total, double q,
+                               float lo, float hi) {
+        double target = q * static_cast<double>(total);
+        uint64_t cumulative = 0;
+        for (int i = 0; i < CONFIDENCE_BINS; ++i) {
+            if (bins[i] == 0) continue;
+            if (static_cast<double>(cumulative + bins[i]) >= target) {
+                double frac = (target - cumulative) / static_cast<double>(bins[i]);
+                double v = (i + frac) / CONFIDENCE_BINS;
+                return static_cast<float>(std::min<double>(std::max<double>(v, lo), hi));
+            }
+            cumulative += bins[i];
+        }
+        return hi;
+    }
+};
+
+// ============================================================================
+// PER-MODEL HEALTH (FIXED TABLE, LOCK-FREE)
+// ============================================================================
+
+struct ModelHealth {
+    int model_id = -1;              // -1 for the shared out-of-range slot
+    uint64_t passed = 0;
+    uint64_t grace = 0;
+    uint64_t rejected = 0;
+    uint64_t disagreed = 0;
+
+    uint64_t signals() const { return passed + grace + rejected; }
+    float passRate() const { return rate(passed); }
+    float graceRate() const { return rate(grace); }
+    float rejectRate() const { return rate(rejected); }
+    // Fraction of admitted signals that disagreed with the median
+    float disagreeRate() const {
+        uint64_t admitted = passed + grace;
+        return admitted ? static_cast<float>(disagreed) / admitted : 0.0f;
+    }
+
+private:
+    float rate(uint64_t n) const {
+        uint64_t total = signals();
+        return total ? static_cast<float>(n) / total : 0.0f;
+    }
+};
+
+// Indexed directly by model_id in [0, MAX_MODEL_IDS); other IDs share one
+// slot. Written from engine threads via DecisionObserver::onModelOutcomes.
+class ModelHealthTable {
+public:
+    static constexpr int MAX_MODEL_IDS = AILLE_METRICS_MAX_MODELS;
+    static constexpr int OUTCOME_COUNT = static_cast<int>(MODEL_DISAGREED) + 1;
+
+private:
+    std::atomic<uint64_t> counts[MAX_MODEL_IDS + 1][OUTCOME_COUNT] = {};
+
+public:
+    void record(int model_id, ModelOutcome outcome) {
+        int slot = (model_id >= 0 && model_id < MAX_MODEL_IDS) ? model_id : MAX_MODEL_IDS;
+        int o = static_cast<int>(outcome);
+        if (o < 0 || o >= OUTCOME_COUNT) return;
+        counts[slot][o].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Out-of-range IDs return the shared slot (model_id = -1)
+    ModelHealth get(int model_id) const {
+        int slot = (model_id >= 0 && model_id < MAX_MODEL_IDS) ? model_id : MAX_MODEL_IDS;
+        ModelHealth h;
+        h.model_id = slot < MAX_MODEL_IDS ? slot : -1;
+        h.passed = counts[slot][MODEL_PASSED].load(std::memory_order_relaxed);
+        h.grace = counts[slot][MODEL_GRACE].load(std::memory_order_relaxed);
+        h.rejected = counts[slot][MODEL_REJECTED].load(std::memory_order_relaxed);
+        h.disagreed = counts[slot][MODEL_DISAGREED].load(std::memory_order_relaxed);
+        return h;
+    }
+
+    // Models that reported at least one signal (shared slot last)
+    std::vector<ModelHealth> getAll() const {
+        std::vector<ModelHealth> out;
+        for (int slot = 0; slot <= MAX_MODEL_IDS; ++slot) {
+            ModelHealth h = get(slot < MAX_MODEL_IDS ? slot : -1);
+            if (h.signals() > 0) out.push_back(h);
+        }
+        return out;
+    }
+
+    void reset() {
+        for (auto& row : counts) {
+            for (auto& c : row) c.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void copyTo(uint64_t (&out)[MAX_MODEL_IDS + 1][OUTCOME_COUNT]) const {
+        for (int m = 0; m <= MAX_MODEL_IDS; ++m) {
+            for (int o = 0; o < OUTCOME_COUNT; ++o) {
+                out[m][o] = counts[m][o].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static void encodeState(StateEncoder& enc,
+                            const uint64_t (&in)[MAX_MODEL_IDS + 1][OUTCOME_COUNT]) {
+        enc.u32(MAX_MODEL_IDS);
+        enc.u32(OUTCOME_COUNT);
+        for (const auto& row : in) {
+            for (uint64_t c : row) enc.u64(c);
+        }
+    }
+
+    static bool decodeState(StateDecoder& dec,
+                            uint64_t (&out)[MAX_MODEL_IDS + 1][OUTCOME_COUNT]) {
+        if (dec.u32() != MAX_MODEL_IDS || dec.u32() != OUTCOME_COUNT) return false;
+        for (auto& row : out) {
+            for (auto& c : row) c = dec.u64();
+        }
+        return dec.ok();
+    }
+
+    void restore(const uint64_t (&in)[MAX_MODEL_IDS + 1][OUTCOME_COUNT]) {
+        for (int m = 0; m <= MAX_MODEL_IDS; ++m) {
+            for (int o = 0; o < OUTCOME_COUNT; ++o) {
+                counts[m][o].store(in[m][o], std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// ============================================================================
+// PUBLISHED SNAPSHOT (DOUBLE BUFFER, NON-BLOCKING READS)
+// ============================================================================
+//
+// The publisher writes generation g+1 into the slot readers are not using
+// (slot (g+1) & 1), then advances the generation. Each slot carries its own
+// seqlock sequence, so a reader retries only if the writer laps it twice
+// during one copy. Readers never take a lock and never delay the writer.
+// A slot also records which generation it holds: a reader lapped between
+// loading the generation and copying returns the newer generation it
+// actually copied.
+
+class PublishedSnapshot {
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> generation{0};   // written inside the sequence
+        MetricsSnapshot data;
+    };
+
+    Slot slots[2];
+    alignas(64) std::atomic<uint64_t> generation{0};
+
+public:
+    // Single writer; concurrent publishers must serialize externally
+    void publish(const MetricsSnapshot& s) {
+        uint64_t next = generation.load(std::memory_order_relaxed) + 1;
+        Slot& slot = slots[next & 1];
+        uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.generation.store(next, std::memory_order_relaxed);
+        std::memcpy(static_cast<void*>(&slot.data), &s, sizeof(s));
+        slot.sequence.store(seq + 2, std::memory_order_release);
+        generation.store(next, std::memory_order_release);
+    }
+
+    // Copies the latest snapshot; returns its generation (0 = none yet)
+    uint64_t read(MetricsSnapshot& out) const {
+        while (true) {
+            uint64_t g = generation.load(std::memory_order_acquire);
+            if (g == 0) {
+                out = MetricsSnapshot();
+                return 0;
+            }
+            const Slot& slot = slots[g & 1];
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            uint64_t copied = slot.generation.load(std::memory_order_relaxed);
+            std::memcpy(static_cast<void*>(&out), &slot.data, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) return copied;
+        }
+    }
+
+    uint64_t getGeneration() const { return generation.load(std::memory_order_acquire); }
+};
+
+// ============================================================================
+// METRICS POLICIES (COMPILE-TIME FEATURE SELECTION)
+// ============================================================================
+//
+// Each flag compiles one statistic in or out of BasicMetricsCollector.
+// A disabled feature is an empty base class (zero bytes through the empty
+// base optimization) and every use of it sits behind `if constexpr`, so it
+// costs no instructions either. The runtime MetricsConfig switches
+// (enable_histograms, quantile_sketch_k, rolling_window_buckets, ...)
+// still apply to the features that are compiled in.
+
+struct FullMetricsPolicy {
+    static constexpr bool enabled = true;            // false: collector work compiles away
+    static constexpr bool confidence_window = true;  // windowed confidence statistics
+    static constexpr bool quantile_sketch = true;    // KLL confidence quantiles
+    static constexpr bool histograms = true;         // confidence / final value / latency
+    static constexpr bool rolling_windows = true;    // time-bucketed windows
+    static constexpr bool model_health = true;       // per-model outcome table
+};
+
+// Decision counts, rates and the agreement histogram only
+struct CountersOnlyMetricsPolicy {
+    static constexpr bool enabled = true;
+    static constexpr bool confidence_window = false;
+    static constexpr bool quantile_sketch = false;
+    static constexpr bool histograms = false;
+    static constexpr bool rolling_windows = false;
+    static constexpr bool model_health = false;
+};
+
+// The collector's side of every observation is an empty function and
+// snapshots stay empty. It is still a DecisionObserver: an engine it is
+// attached to keeps timing each decision and making the virtual calls,
+// so detach it (setObserver(nullptr)) to remove that cost too.
+struct NullMetricsPolicy {
+    static constexpr bool enabled = false;
+    static constexpr bool confidence_window = false;
+    static constexpr bool quantile_sketch = false;
+    static constexpr bool histograms = false;
+    static constexpr bool rolling_windows = false;
+    static constexpr bool model_health = false;
+};
+
+namespace detail {
+
+// Disabled histograms get a minimal two-bucket layout
+inline HistogramConfig confidenceHistogramConfig(const MetricsConfig& cfg) {
+    if (!cfg.enable_histograms) return HistogramConfig(1.0, 1.0, 1);
+    return HistogramConfig(1e-4, 1.0, cfg.histogram_precision_bits);
+}
+
+inline HistogramConfig finalValueHistogramConfig(const MetricsConfig& cfg) {
+    if (!cfg.enable_histograms) return HistogramConfig(1.0, 1.0, 1);
+    return HistogramConfig(1e-4, cfg.max_tracked_value,
+                           cfg.histogram_precision_bits, true);
+}
+
+inline HistogramConfig latencyHistogramConfig(const MetricsConfig& cfg) {
+    if (!cfg.enable_histograms) return HistogramConfig(1.0, 1.0, 1);
+    return HistogramConfig(cfg.latency_resolution_ns, cfg.max_tracked_latency_ns,
+                           cfg.latency_precision_bits);
+}
+
+// Feature state mixins: the primary templates are the empty (disabled)
+// versions, the <true> specializations hold the data. All are protected by
+// the collector mutex unless noted.
+
+template <bool Enabled>
+struct ConfidenceWindowState {
+    explicit ConfidenceWindowState(const MetricsConfig&) {}
+};
+
+template <>
+struct ConfidenceWindowState<true> {
+    // Circular buffer for confidence samples (bounded memory)
+    static constexpr size_t MAX_SAMPLES = 10000;
+    size_t window_capacity = MAX_SAMPLES;
+    std::vector<float> confidence_samples;
+    size_t sample_write_index = 0;
+    bool samples_buffer_full = false;
+
+    // Windowed online statistics over confidence_samples. Sums are
+    // maintained by adding the incoming sample and subtracting the evicted
+    // one; min/max use monotonic deques of (sequence, value) pairs so that
+    // every statistic is O(1) amortized per decision. With a zero-sized
+    // window the same fields hold lifetime statistics.
+    double window_sum = 0.0;
+    double window_sum_sq = 0.0;
+    uint64_t samples_seen = 0;
+    std::deque<std::pair<uint64_t, float>> window_min; // values increasing
+    std::deque<std::pair<uint64_t, float>> window_max; // values decreasing
+
+    explicit ConfidenceWindowState(const MetricsConfig& cfg)
+        : window_capacity(cfg.confidence_window) {
+        confidence_samples.reserve(window_capacity);
+    }
+
+    // Circular buffer management
+    void addConfidenceSample(float confidence) {
+        bool windowed = window_capacity > 0;
+        if (!windowed) {
+            // Lifetime statistics, no raw samples retained
+        } else if (confidence_samples.size() < window_capacity) {
+            confidence_samples.push_back(confidence);
+        } else {
+            samples_buffer_full = true;
+            float evicted = confidence_samples[sample_write_index];
+            window_sum -= evicted;
+            window_sum_sq -= static_cast<double>(evicted) * evicted;
+            confidence_samples[sample_write_index] = confidence;
+            sample_write_index = (sample_write_index + 1) % window_capacity;
+        }
+
+        window_sum += confidence;
+        window_sum_sq += static_cast<double>(confidence) * confidence;
+
+        // Monotonic deques: drop dominated values, then expire the front.
+        // Without a window only the running extreme is kept.
+        uint64_t seq = samples_seen++;
+        if (windowed || window_min.empty() || confidence < window_min.front().second) {
+            while (!window_min.empty() && window_min.back().second >= confidence) {
+                window_min.pop_back();
+            }
+            window_min.emplace_back(seq, confidence);
+        }
+        if (windowed || window_max.empty() || confidence > window_max.front().second) {
+            while (!window_max.empty() && window_max.back().second <= confidence) {
+                window_max.pop_back();
+            }
+            window_max.emplace_back(seq, confidence);
+        }
+
+        if (windowed) {
+            uint64_t oldest =
+                (samples_seen > window_capacity) ? samples_seen - window_capacity : 0;
+            while (window_min.front().first < oldest) window_min.pop_front();
+            while (window_max.front().first < oldest) window_max.pop_front();
+        }
+    }
+
+    size_t samplesInWindow() const {
+        return window_capacity > 0 ? confidence_samples.size()
+                                   : static_cast<size_t>(samples_seen);
+    }
+
+    // Confidence statistics (constant time)
+    void fillConfidenceStatistics(MetricsSnapshot& s) const {
+        if (samplesInWindow() == 0) {
+            s.average_confidence = 0.0f;
+            s.min_confidence = 0.0f;
+            s.max_confidence = 0.0f;
+            s.stddev_confidence = 0.0f;
+            return;
+        }
+
+        double n = static_cast<double>(samplesInWindow());
+        double mean = window_sum / n;
+        s.average_confidence = static_cast<float>(mean);
+
+        s.min_confidence = window_min.front().second;
+        s.max_confidence = window_max.front().second;
+
+        // Population variance from running sums; clamp rounding noise
+        double variance = window_sum_sq / n - mean * mean;
+        s.stddev_confidence = static_cast<float>(std::sqrt(std::max(variance, 0.0)));
+    }
+
+    void resetWindow() {
+        confidence_samples.clear();
+        sample_write_index = 0;
+        samples_buffer_full = false;
+        window_sum = 0.0;
+        window_sum_sq = 0.0;
+        samples_seen = 0;
+        window_min.clear();
+        window_max.clear();
+    }
+
+    void encodeState(StateEncoder& enc) const {
+        enc.u64(confidence_samples.size());
+        for (float v : confidence_samples) enc.f32(v);
+        enc.u64(sample_write_index);
+        enc.u32(samples_buffer_full ? 1u : 0u);
+        enc.f64(window_sum);
+        enc.f64(window_sum_sq);
+        enc.u64(samples_seen);
+        for (const auto* dq : {&window_min, &window_max}) {
+            enc.u64(dq->size());
+            for (const auto& e : *dq) {
+                enc.u64(e.first);
+                enc.f32(e.second);
+            }
+        }
+    }
+
+    // Decodes into this (freshly constructed, same capacity) state
+    bool decodeState(StateDecoder& dec) {
+        uint64_t count = dec.u64();
+        if (count > window_capacity || !dec.fits(count, 4)) return false;
+        confidence_samples.resize(static_cast<size_t>(count));
+        for (float& v : confidence_samples) v = dec.f32();
+        uint64_t write_index = dec.u64();
+        if (write_index >= std::max<size_t>(window_capacity, 1)) return false;
+        sample_write_index = static_cast<size_t>(write_index);
+        samples_buffer_full = dec.u32() != 0;
+        window_sum = dec.f64();
+        window_sum_sq = dec.f64();
+        samples_seen = dec.u64();
+        for (auto* dq : {&window_min, &window_max}) {
+            uint64_t entries = dec.u64();
+            if (!dec.fits(entries, 12)) return false;
+            for (uint64_t i = 0; i < entries; ++i) {
+                uint64_t seq = dec.u64();
+                dq->emplace_back(seq, dec.f32());
+            }
+        }
+        if (samplesInWindow() > 0 && (window_min.empty() || window_max.empty())) return false;
+        return dec.ok();
+    }
+};
+
+template <bool Enabled>
+struct QuantileSketchState {
+    explicit QuantileSketchState(const MetricsConfig&) {}
+};
+
+template <>
+struct QuantileSketchState<true> {
+    // Streaming confidence quantiles
+    KllSketch confidence_sketch;
+
+    explicit QuantileSketchState(const MetricsConfig& cfg)
+        : confidence_sketch(cfg.quantile_sketch_k > 0 ? cfg.quantile_sketch_k
+                                                      : KllSketch::MIN_LEVEL_CAPACITY) {}
+
+    void encodeState(StateEncoder& enc) const {
+        const auto& levels = confidence_sketch.getLevels();
+        enc.u64(confidence_sketch.getN());
+        enc.f32(confidence_sketch.getMin());
+        enc.f32(confidence_sketch.getMax());
+        enc.u64(levels.size());
+        for (const auto& level : levels) {
+            enc.u64(level.size());
+            for (float v : level) enc.f32(v);
+        }
+    }
+
+    bool decodeState(StateDecoder& dec) {
+        uint64_t n = dec.u64();
+        float lo = dec.f32();
+        float hi = dec.f32();
+        uint64_t level_count = dec.u64();
+        if (level_count > 64 || !dec.fits(level_count, 8)) return false;
+        std::vector<std::vector<float>> levels(static_cast<size_t>(level_count));
+        for (auto& level : levels) {
+            uint64_t items = dec.u64();
+            if (!dec.fits(items, 4)) return false;
+            level.resize(static_cast<size_t>(items));
+            for (float& v : level) v = dec.f32();
+        }
+        if (!dec.ok()) return false;
+        confidence_sketch.restore(n, lo, hi, levels);
+        return true;
+    }
+};
+
+template <bool Enabled>
+struct HistogramState {
+    explicit HistogramState(const MetricsConfig&) {}
+};
+
+template <>
+struct HistogramState<true> {
+    // Full distributions (O(1) record)
+    LogLinearHistogram confidence_histogram;
+    LogLinearHistogram final_value_histogram;
+    LogLinearHistogram latency_histogram;
+    // DECISION_STATUS_COUNT entries with MetricsConfig::latency_by_status,
+    // otherwise empty
+    std::vector<LogLinearHistogram> latency_by_status;
+
+    explicit HistogramState(const MetricsConfig& cfg)
+        : confidence_histogram(confidenceHistogramConfig(cfg)),
+          final_value_histogram(finalValueHistogramConfig(cfg)),
+          latency_histogram(latencyHistogramConfig(cfg)) {
+        if (cfg.enable_histograms && cfg.latency_by_status) {
+            latency_by_status.assign(DECISION_STATUS_COUNT,
+                                     LogLinearHistogram(latencyHistogramConfig(cfg)));
+        }
+    }
+
+    void recordLatency(DecisionStatus status, uint64_t latency_ns) {
+        latency_histogram.record(static_cast<double>(latency_ns));
+        int i = static_cast<int>(status);
+        if (i >= 0 && static_cast<size_t>(i) < latency_by_status.size()) {
+            latency_by_status[i].record(static_cast<double>(latency_ns));
+        }
+    }
+
+    // Same-layout copy without reallocating
+    void copyHistogramsFrom(const HistogramState& other) {
+        confidence_histogram.copyFrom(other.confidence_histogram);
+        final_value_histogram.copyFrom(other.final_value_histogram);
+        latency_histogram.copyFrom(other.latency_histogram);
+        for (size_t i = 0; i < latency_by_status.size(); ++i) {
+            latency_by_status[i].copyFrom(other.latency_by_status[i]);
+        }
+    }
+
+    void resetHistograms() {
+        confidence_histogram.reset();
+        final_value_histogram.reset();
+        latency_histogram.reset();
+        for (auto& h : latency_by_status) h.reset();
+    }
+
+    void encodeState(StateEncoder& enc) const {
+        enc.bytes(confidence_histogram.encode());
+        enc.bytes(final_value_histogram.encode());
+        enc.bytes(latency_histogram.encode());
+        for (const auto& h : latency_by_status) enc.bytes(h.encode());
+    }
+
+    bool decodeState(StateDecoder& dec) {
+        if (!decodeHistogram(dec, confidence_histogram) ||
+            !decodeHistogram(dec, final_value_histogram) ||
+            !decodeHistogram(dec, latency_histogram)) {
+            return false;
+        }
+        for (auto& h : latency_by_status) {
+            if (!decodeHistogram(dec, h)) return false;
+        }
+        return true;
+    }
 
-struct MetricsSnapshot {
-    uint64_t total_decisions = 0;
-    uint64_t valid_decisions = 0;
-    uint64_t fallback_activations = 0;
-    uint64_t rejected_confidence = 0;
-    uint64_t rejected_consensus = 0;
-    uint64_t invalid_inputs = 0;
+    // Histogram images must match the configured bucket layout exactly
+    static bool decodeHistogram(StateDecoder& dec, LogLinearHistogram& target) {
+        size_t length = 0;
+        const uint8_t* blob = dec.bytes(length);
+        LogLinearHistogram decoded;
+        if (!blob || !LogLinearHistogram::decode(blob, length, decoded) ||
+            !target.isCompatible(decoded)) {
+            return false;
+        }
+        target.copyFrom(decoded);
+        return true;
+    }
+};
 
-    float average_confidence = 0.0f;
-    float fallback_rate = 0.0f;
-    float consensus_failure_rate = 0.0f;
-    float min_confidence = 0.0f;
-    float max_confidence = 0.0f;
-    float stddev_confidence = 0.0f;
+template <bool Enabled>
+struct RollingWindowState {
+    explicit RollingWindowState(const MetricsConfig&) {}
+};
 
-    std::unordered_map<int, uint64_t> models_agreed_histogram;
+template <>
+struct RollingWindowState<true> {
+    // Time-bucketed rolling windows
+    RollingWindowMetrics rolling_windows;
 
-    uint64_t last_decision_timestamp_ns = 0;
-    bool overflow_detected = false;
+    explicit RollingWindowState(const MetricsConfig& cfg)
+        : rolling_windows(cfg.rolling_window_buckets, cfg.rolling_bucket_ns) {}
 };
 
-// ============================================================================
-// METRICS COLLECTOR (PRODUCTION-HARDENED, THREAD-SAFE)
-// ============================================================================
+template <bool Enabled>
+struct ModelHealthState {
+    explicit ModelHealthState(const MetricsConfig&) {}
+};
+
+template <>
+struct ModelHealthState<true> {
+    // Per-model outcomes from the engine observer (atomic, no mutex)
+    ModelHealthTable model_health;
+
+    explicit ModelHealthState(const MetricsConfig&) {}
+};
+
+// Configuration, counters, lock and sampling state; the Null policy
+// carries none of it
+template <bool Enabled>
+struct CoreState {
+    explicit CoreState(const MetricsConfig&) {}
+};
+
+template <>
+struct CoreState<true> {
+    MetricsConfig config;
 
-class MetricsCollector {
-private:
     // Thread safety
     mutable std::mutex mtx;
-    
+
     // Core metrics (protected by mutex)
     MetricsSnapshot snapshot;
-    
-    // Circular buffer for confidence samples (bounded memory)
-    static constexpr size_t MAX_SAMPLES = 10000;
-    std::vector<float> confidence_samples;
-    size_t sample_write_index = 0;
-    bool samples_buffer_full = false;
-    
+
+    // Sampling state: decisions left until the next sampled one
+    uint64_t sample_countdown = 1;
+    uint64_t sampling_rng;
+
     // Atomic overflow detection
     std::atomic<bool> overflow_flag{false};
 
-public:
-    MetricsCollector() {
-        confidence_samples.reserve(MAX_SAMPLES);
+    explicit CoreState(const MetricsConfig& cfg)
+        : config(cfg), sampling_rng(cfg.sampling_seed ? cfg.sampling_seed : 1) {
+        config.sample_every = std::max<uint32_t>(1, config.sample_every);
     }
+};
 
-    // Called externally after each decision
-    void observeDecision(const Decision& d) {
-        std::lock_guard<std::mutex> lock(mtx);
+// Reusable buffers for allocation-free snapshots
+struct SnapshotScratch {
+    LogLinearHistogram confidence;
+    LogLinearHistogram final_value;
+    LogLinearHistogram latency;
+    std::vector<LogLinearHistogram> latency_by_status;
+};
 
-        // Input validation
-        if (!isValidDecision(d)) {
-            snapshot.invalid_inputs++;
-            return;
-        }
+template <bool Enabled>
+struct PublishState {
+    explicit PublishState(const MetricsConfig&) {}
+};
 
-        // Overflow protection
-        if (snapshot.total_decisions == UINT64_MAX) {
-            overflow_flag.store(true);
-            snapshot.overflow_detected = true;
-            return;
+template <>
+struct PublishState<true> {
+    // Double-buffered publication (independent of the collector mutex)
+    PublishedSnapshot published;
+    std::mutex publish_mtx;                   // serializes publishers
+    std::unique_ptr<SnapshotScratch> publish_scratch;
+    std::mutex publisher_state_mtx;
+    std::condition_variable publisher_cv;
+    std::thread publisher_thread;
+    bool publisher_running = false;           // protected by publisher_state_mtx
+
+    explicit PublishState(const MetricsConfig&) {}
+};
+
+} // namespace detail
+
+// ============================================================================
+// METRICS COLLECTOR (PRODUCTION-HARDENED, THREAD-SAFE)
+// ============================================================================
+
+template <class Policy>
+class BasicMetricsCollector
+    : public DecisionObserver,
+      private detail::CoreState<Policy::enabled>,
+      private detail::ConfidenceWindowState<Policy::confidence_window>,
+      private detail::QuantileSketchState<Policy::quantile_sketch>,
+      private detail::HistogramState<Policy::histograms>,
+      private detail::RollingWindowState<Policy::rolling_windows>,
+      private detail::ModelHealthState<Policy::model_health>,
+      private detail::PublishState<Policy::enabled> {
+private:
+    using CoreState = detail::CoreState<Policy::enabled>;
+    using PublishState = detail::PublishState<Policy::enabled>;
+    using WindowState = detail::ConfidenceWindowState<Policy::confidence_window>;
+    using SketchState = detail::QuantileSketchState<Policy::quantile_sketch>;
+    using HistState = detail::HistogramState<Policy::histograms>;
+    using RollingState = detail::RollingWindowState<Policy::rolling_windows>;
+    using HealthState = detail::ModelHealthState<Policy::model_health>;
+
+public:
+    using policy_type = Policy;
+
+    BasicMetricsCollector() : BasicMetricsCollector(MetricsConfig()) {}
+    ~BasicMetricsCollector() override { stopPublishing(); }
+
+    BasicMetricsCollector(const BasicMetricsCollector&) = delete;
+    BasicMetricsCollector& operator=(const BasicMetricsCollector&) = delete;
+
+    explicit BasicMetricsCollector(const MetricsConfig& cfg)
+        : CoreState(cfg),
+          WindowState(cfg),
+          SketchState(cfg),
+          HistState(cfg),
+          RollingState(cfg),
+          HealthState(cfg),
+          PublishState(cfg) {}
+
+    // Called externally after each decision. Latency comes from
+    // Decision::latency_ns, which the engine fills while an observer is
+    // attached; a nonzero latency_ns argument (e.g. timed by the caller)
+    // takes its place.
+    void observeDecision(const Decision& d, uint64_t latency_ns = 0) {
+        if constexpr (Policy::enabled) {
+            recordDecision(d, latency_ns);
+        } else {
+            (void)d;
+            (void)latency_ns;
         }
+    }
 
-        snapshot.total_decisions++;
-        snapshot.last_decision_timestamp_ns = d.timestamp_ns;
+    // DecisionObserver: onDecisionLatency() is not overridden; the same
+    // latency arrives on Decision::latency_ns and is recorded inside
+    // observeDecision()'s critical section instead of taking the lock twice.
 
-        // Circular buffer management (bounded memory)
-        addConfidenceSample(d.confidence);
+    // DecisionObserver: per-signal results from the safety and consensus layers
+    void onModelOutcome(int model_id, ModelOutcome outcome) override {
+        if constexpr (Policy::enabled && Policy::model_health) {
+            this->model_health.record(model_id, outcome);
+        } else {
+            (void)model_id;
+            (void)outcome;
+        }
+    }
 
-        // Status tracking
-        switch (d.status) {
-            case DECISION_VALID:
-                snapshot.valid_decisions++;
-                break;
-            case REJECTED_LOW_CONFIDENCE:
-                snapshot.rejected_confidence++;
-                snapshot.fallback_activations++;
-                break;
-            case REJECTED_NO_CONSENSUS:
-                snapshot.rejected_consensus++;
-                snapshot.fallback_activations++;
-                break;
-            case FALLBACK_ACTIVATED:
-                snapshot.fallback_activations++;
-                break;
-            default:
-                // Unknown status - log but don't crash
-                break;
+    // DecisionObserver: one virtual call per decision for all its outcomes
+    void onModelOutcomes(const ModelOutcomeReport* reports, size_t count) override {
+        if constexpr (Policy::enabled && Policy::model_health) {
+            for (size_t i = 0; i < count; ++i) {
+                this->model_health.record(reports[i].model_id, reports[i].outcome);
+            }
+        } else {
+            (void)reports;
+            (void)count;
         }
+    }
 
-        // Histogram tracking with bounds checking
-        if (d.models_agreed >= 0 && d.models_agreed < 1000) {
-            snapshot.models_agreed_histogram[d.models_agreed]++;
+    ModelHealth getModelHealth(int model_id) const {
+        if constexpr (Policy::model_health) {
+            return this->model_health.get(model_id);
+        } else {
+            ModelHealth h;
+            h.model_id = model_id;
+            return h;
         }
+    }
+
+    std::vector<ModelHealth> getModelHealthTable() const {
+        if constexpr (Policy::model_health) return this->model_health.getAll();
+        return {};
+    }
+
+    // Reusable buffers for allocation-free snapshots (see makeScratch())
+    using Scratch = detail::SnapshotScratch;
 
-        recomputeStatistics();
+    // Buffers laid out like this collector's histograms (allocates once)
+    Scratch makeScratch() const {
+        if constexpr (Policy::histograms) {
+            return Scratch{LogLinearHistogram(this->confidence_histogram.getConfig()),
+                           LogLinearHistogram(this->final_value_histogram.getConfig()),
+                           LogLinearHistogram(this->latency_histogram.getConfig()),
+                           this->latency_by_status};
+        } else {
+            return Scratch{LogLinearHistogram(HistogramConfig(1.0, 1.0, 1)),
+                           LogLinearHistogram(HistogramConfig(1.0, 1.0, 1)),
+                           LogLinearHistogram(HistogramConfig(1.0, 1.0, 1)),
+                           {}};
+        }
     }
 
     // Thread-safe snapshot retrieval
     MetricsSnapshot getSnapshot() const {
-        std::lock_guard<std::mutex> lock(mtx);
-        return snapshot;
+        Scratch scratch = makeScratch();
+        return getSnapshot(scratch);
+    }
+
+    // Snapshot through caller-owned buffers: the lock is held only for
+    // memcpy of the counters and histogram buckets; percentiles are
+    // computed after it is released.
+    MetricsSnapshot getSnapshot(Scratch& scratch) const {
+        MetricsSnapshot out;
+        if constexpr (!Policy::enabled) {
+            (void)scratch;
+            return out;
+        } else {
+            size_t window_samples = 0;
+            {
+                std::lock_guard<std::mutex> lock(this->mtx);
+                out = this->snapshot;
+                window_samples = samplesInWindow();
+                if constexpr (Policy::histograms) {
+                    if (this->config.enable_histograms) {
+                        scratch.confidence.copyFrom(this->confidence_histogram);
+                        scratch.final_value.copyFrom(this->final_value_histogram);
+                        scratch.latency.copyFrom(this->latency_histogram);
+                        for (size_t i = 0; i < this->latency_by_status.size(); ++i) {
+                            scratch.latency_by_status[i].copyFrom(this->latency_by_status[i]);
+                        }
+                    }
+                }
+            }
+
+            if (histogramsEnabled()) {
+                out.confidence_percentiles.fillFrom(scratch.confidence);
+                out.final_value_percentiles.fillFrom(scratch.final_value);
+                out.latency_ns_percentiles.fillFrom(scratch.latency);
+                for (size_t i = 0; i < scratch.latency_by_status.size(); ++i) {
+                    out.latency_ns_by_status[i].fillFrom(scratch.latency_by_status[i]);
+                }
+            }
+            applySampling(out, window_samples, this->config.sample_every);
+            return out;
+        }
+    }
+
+    // Publishes a fresh snapshot for getPublishedSnapshot() readers. The
+    // collector lock is held only for the memcpy inside getSnapshot().
+    // Returns the new generation (always 0 for the Null policy).
+    uint64_t publishSnapshot() {
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->publish_mtx);
+            if (!this->publish_scratch) this->publish_scratch.reset(new Scratch(makeScratch()));
+            this->published.publish(getSnapshot(*this->publish_scratch));
+            return this->published.getGeneration();
+        }
+        return 0;
+    }
+
+    // Latest published snapshot without touching the collector lock, for
+    // dashboards polling at high rates. Returns its generation (0 = never
+    // published; out is then an empty snapshot).
+    uint64_t getPublishedSnapshot(MetricsSnapshot& out) const {
+        if constexpr (Policy::enabled) return this->published.read(out);
+        out = MetricsSnapshot();
+        return 0;
+    }
+
+    uint64_t getPublishedGeneration() const {
+        if constexpr (Policy::enabled) return this->published.getGeneration();
+        return 0;
+    }
+
+    // Background publication every `interval` (replaces a running
+    // publisher; does nothing for the Null policy)
+    void startPublishing(std::chrono::milliseconds interval) {
+        if constexpr (Policy::enabled) {
+            stopPublishing();
+            std::lock_guard<std::mutex> lock(this->publisher_state_mtx);
+            this->publisher_running = true;
+            this->publisher_thread = std::thread([this, interval]() {
+                std::unique_lock<std::mutex> state(this->publisher_state_mtx);
+                while (this->publisher_running) {
+                    state.unlock();
+                    publishSnapshot();
+                    state.lock();
+                    this->publisher_cv.wait_for(state, interval,
+                                                [this]() { return !this->publisher_running; });
+                }
+            });
+        } else {
+            (void)interval;
+        }
+    }
+
+    void stopPublishing() {
+        if constexpr (Policy::enabled) {
+            {
+                std::lock_guard<std::mutex> lock(this->publisher_state_mtx);
+                if (!this->publisher_running) return;
+                this->publisher_running = false;
+            }
+            this->publisher_cv.notify_all();
+            if (this->publisher_thread.joinable()) this->publisher_thread.join();
+        }
+    }
+
+    // Rolling-window snapshot over the trailing `window` ending at now_ns
+    // (defaults to the current time on the Decision::timestamp_ns clock).
+    // Requires MetricsConfig::rolling_window_buckets > 0; cost is O(buckets
+    // in window). Confidence percentiles come from per-bucket 64-bin
+    // histograms; final_value/latency distributions are lifetime-only.
+    MetricsSnapshot getSnapshot(std::chrono::nanoseconds window,
+                                uint64_t now_ns = currentTimestampNs()) const {
+        RollingWindowMetrics::WindowCopy scratch;
+        return getSnapshot(window, scratch, now_ns);
+    }
+
+    // Same, through a caller-owned copy buffer: the lock is held only
+    // while the window's live buckets are copied; they are merged after
+    // it is released.
+    MetricsSnapshot getSnapshot(std::chrono::nanoseconds window,
+                                RollingWindowMetrics::WindowCopy& scratch,
+                                uint64_t now_ns = currentTimestampNs()) const {
+        MetricsSnapshot out;
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            if constexpr (Policy::rolling_windows) {
+                this->rolling_windows.copyWindow(static_cast<uint64_t>(window.count()), now_ns,
+                                                 scratch);
+            }
+            out.last_decision_timestamp_ns = this->snapshot.last_decision_timestamp_ns;
+            out.overflow_detected = this->snapshot.overflow_detected;
+        }
+        if constexpr (Policy::rolling_windows) {
+            RollingWindowMetrics::aggregate(scratch, out);
+        } else {
+            (void)window;
+            (void)scratch;
+            (void)now_ns;
+        }
+        return out;
+    }
+
+    uint64_t getRollingHorizonNs() const {
+        if constexpr (Policy::rolling_windows) return this->rolling_windows.horizonNs();
+        return 0;
+    }
+
+    // Approximate confidence at normalized rank q in [0, 1] (KLL sketch).
+    // The sketch is copied under the lock and queried after releasing it.
+    float getConfidenceQuantile(double q) const {
+        KllSketch sketch = getConfidenceSketch();
+        return sketch.quantile(q);
+    }
+
+    KllSketch getConfidenceSketch() const {
+        if constexpr (Policy::quantile_sketch) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return this->confidence_sketch;
+        } else {
+            return KllSketch();
+        }
+    }
+
+    // Distribution copies, e.g. for merging across collectors or processes
+    LogLinearHistogram getConfidenceHistogram() const {
+        if constexpr (Policy::histograms) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return this->confidence_histogram;
+        } else {
+            return LogLinearHistogram(detail::confidenceHistogramConfig(activeConfig()));
+        }
+    }
+
+    LogLinearHistogram getFinalValueHistogram() const {
+        if constexpr (Policy::histograms) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return this->final_value_histogram;
+        } else {
+            return LogLinearHistogram(detail::finalValueHistogramConfig(activeConfig()));
+        }
+    }
+
+    LogLinearHistogram getLatencyHistogram() const {
+        if constexpr (Policy::histograms) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return this->latency_histogram;
+        } else {
+            return LogLinearHistogram(detail::latencyHistogramConfig(activeConfig()));
+        }
+    }
+
+    LogLinearHistogram getLatencyHistogram(DecisionStatus status) const {
+        if constexpr (Policy::histograms) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            int i = static_cast<int>(status);
+            return (i >= 0 && static_cast<size_t>(i) < this->latency_by_status.size())
+                       ? this->latency_by_status[i]
+                       : LogLinearHistogram(this->latency_histogram.getConfig());
+        } else {
+            (void)status;
+            return LogLinearHistogram(detail::latencyHistogramConfig(activeConfig()));
+        }
     }
 
     // Simple health check for dashboards / alerts
     bool isHealthy(float max_fallback_rate = 0.10f) const {
-        std::lock_guard<std::mutex> lock(mtx);
-        return snapshot.fallback_rate <= max_fallback_rate && 
-               !snapshot.overflow_detected;
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return fallbackRate(this->snapshot) <= max_fallback_rate &&
+                   !this->snapshot.overflow_detected;
+        } else {
+            (void)max_fallback_rate;
+            return true;
+        }
     }
 
     // Reset metrics (useful for testing or periodic resets)
     void reset() {
-        std::lock_guard<std::mutex> lock(mtx);
-        snapshot = MetricsSnapshot();
-        confidence_samples.clear();
-        sample_write_index = 0;
-        samples_buffer_full = false;
-        overflow_flag.store(false);
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            this->snapshot = MetricsSnapshot();
+            if constexpr (Policy::confidence_window) this->resetWindow();
+            if constexpr (Policy::quantile_sketch) this->confidence_sketch.reset();
+            if constexpr (Policy::rolling_windows) this->rolling_windows.reset();
+            if constexpr (Policy::histograms) this->resetHistograms();
+            if constexpr (Policy::model_health) this->model_health.reset();
+            this->sample_countdown = 1;
+            this->sampling_rng = this->config.sampling_seed ? this->config.sampling_seed : 1;
+            this->overflow_flag.store(false);
+        }
     }
 
     // Get current sample count (for diagnostics)
     size_t getSampleCount() const {
-        std::lock_guard<std::mutex> lock(mtx);
-        return samples_buffer_full ? MAX_SAMPLES : confidence_samples.size();
+        if constexpr (Policy::confidence_window) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            return this->confidence_samples.size();
+        }
+        return 0;
     }
 
-private:
-    // Input validation
-    bool isValidDecision(const Decision& d) const {
-        // Validate confidence range
-        if (std::isnan(d.confidence) || std::isinf(d.confidence)) {
-            return false;
+    // ========================================================================
+    // CHECKPOINT / RESTORE
+    // ========================================================================
+    //
+    // Versioned little-endian image of the complete collector state:
+    // counters, the confidence ring (with its write position and windowed
+    // statistics), the KLL sketch, every histogram, rolling-window buckets,
+    // per-model health and the sampling state, followed by an FNV-1a
+    // checksum. Published snapshots are not included. Features compiled out
+    // by the policy are omitted (the policy is part of the fingerprint).
+
+    static constexpr uint32_t STATE_MAGIC = 0x314d5341;  // "ASM1" little-endian
+    static constexpr uint32_t STATE_VERSION = 3;
+
+    // Raw copy of the checkpointed state (see makeStateScratch()). Once
+    // sized by a first save, later copies reuse its buffers.
+    struct StateScratch {
+        MetricsSnapshot snapshot;
+        WindowState window;
+        SketchState sketch;
+        HistState histograms;
+        RollingWindowMetrics windows{0, 1};
+        uint64_t health[ModelHealthTable::MAX_MODEL_IDS + 1][ModelHealthTable::OUTCOME_COUNT] = {};
+        uint64_t sample_countdown = 1;
+        uint64_t sampling_rng = 0;
+
+        explicit StateScratch(const MetricsConfig& cfg)
+            : window(cfg), sketch(cfg), histograms(cfg) {}
+    };
+
+    StateScratch makeStateScratch() const { return StateScratch(activeConfig()); }
+
+    // `out` is overwritten (its capacity reused). The lock is held only
+    // while raw state is copied into `scratch`; encoding and the checksum
+    // run after it is released.
+    void saveState(std::vector<uint8_t>& out, StateScratch& scratch) const {
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            scratch.snapshot = this->snapshot;
+            if constexpr (Policy::confidence_window) {
+                static_cast<WindowState&>(scratch.window) = static_cast<const WindowState&>(*this);
+            }
+            if constexpr (Policy::quantile_sketch) {
+                scratch.sketch.confidence_sketch = this->confidence_sketch;
+            }
+            if constexpr (Policy::histograms) scratch.histograms.copyHistogramsFrom(*this);
+            if constexpr (Policy::rolling_windows) scratch.windows = this->rolling_windows;
+            scratch.sample_countdown = this->sample_countdown;
+            scratch.sampling_rng = this->sampling_rng;
         }
-        if (d.confidence < 0.0f || d.confidence > 1.0f) {
-            return false;
+        if constexpr (Policy::model_health) this->model_health.copyTo(scratch.health);
+
+        out.clear();
+        StateEncoder enc(out);
+        enc.u32(STATE_MAGIC);
+        enc.u32(STATE_VERSION);
+        enc.u64(layoutFingerprint());
+
+        const MetricsSnapshot& s = scratch.snapshot;
+        enc.u64(s.total_decisions);
+        enc.u64(s.valid_decisions);
+        enc.u64(s.fallback_activations);
+        enc.u64(s.rejected_confidence);
+        enc.u64(s.rejected_consensus);
+        enc.u64(s.invalid_inputs);
+        enc.u64(s.sampled_decisions);
+        enc.u64(s.last_decision_timestamp_ns);
+        enc.u32(s.overflow_detected ? 1u : 0u);
+        enc.u32(ModelsAgreedHistogram::MAX_MODELS);
+        for (uint64_t b : s.models_agreed_histogram.buckets) enc.u64(b);
+        enc.u64(s.models_agreed_histogram.overflow);
+        encodeRegimes(enc, s.fallback_regimes);
+
+        if constexpr (Policy::confidence_window) scratch.window.encodeState(enc);
+        if constexpr (Policy::quantile_sketch) scratch.sketch.encodeState(enc);
+        if constexpr (Policy::histograms) scratch.histograms.encodeState(enc);
+        if constexpr (Policy::rolling_windows) scratch.windows.encodeState(enc);
+        if constexpr (Policy::model_health) ModelHealthTable::encodeState(enc, scratch.health);
+
+        enc.u64(scratch.sample_countdown);
+        enc.u64(scratch.sampling_rng);
+
+        enc.u64(stateChecksum(out.data(), out.size()));
+    }
+
+    void saveState(std::vector<uint8_t>& out) const {
+        StateScratch scratch = makeStateScratch();
+        saveState(out, scratch);
+    }
+
+    std::vector<uint8_t> saveState() const {
+        std::vector<uint8_t> out;
+        saveState(out);
+        return out;
+    }
+
+    // Restores a saveState() image. The image must come from a collector
+    // with the same policy and the same window, sketch, histogram,
+    // rolling-window and sampling configuration; anything else (or a
+    // corrupt/truncated image) returns false and leaves this collector
+    // unchanged. Decoding happens before the lock is taken, so observers
+    // are blocked only for the final swap.
+    bool loadState(const uint8_t* data, size_t size) {
+        if (size < 8 + 8) return false;
+        StateDecoder checksum(data + size - 8, 8);
+        if (checksum.u64() != stateChecksum(data, size - 8)) return false;
+
+        StateDecoder dec(data, size - 8);
+        if (dec.u32() != STATE_MAGIC || dec.u32() != STATE_VERSION) return false;
+        if (dec.u64() != layoutFingerprint()) return false;
+
+        MetricsSnapshot restored;
+        restored.total_decisions = dec.u64();
+        restored.valid_decisions = dec.u64();
+        restored.fallback_activations = dec.u64();
+        restored.rejected_confidence = dec.u64();
+        restored.rejected_consensus = dec.u64();
+        restored.invalid_inputs = dec.u64();
+        restored.sampled_decisions = dec.u64();
+        restored.last_decision_timestamp_ns = dec.u64();
+        restored.overflow_detected = dec.u32() != 0;
+        if (dec.u32() != ModelsAgreedHistogram::MAX_MODELS) return false;
+        for (uint64_t& b : restored.models_agreed_histogram.buckets) b = dec.u64();
+        restored.models_agreed_histogram.overflow = dec.u64();
+        if (!decodeRegimes(dec, restored.fallback_regimes)) return false;
+        restored.fallback_regimes.resume();
+
+        WindowState window(activeConfig());
+        SketchState sketch(activeConfig());
+        HistState histograms(activeConfig());
+        RollingWindowMetrics windows(0, 1);
+        uint64_t health[ModelHealthTable::MAX_MODEL_IDS + 1][ModelHealthTable::OUTCOME_COUNT];
+        if constexpr (Policy::confidence_window) {
+            if (!window.decodeState(dec)) return false;
         }
-        
-        // Validate timestamp (basic sanity check)
-        if (d.timestamp_ns == 0) {
-            return false;
+        if constexpr (Policy::quantile_sketch) {
+            if (!sketch.decodeState(dec)) return false;
         }
-        
-        // Validate models_agreed is reasonable
-        if (d.models_agreed < 0) {
-            return false;
+        if constexpr (Policy::histograms) {
+            if (!histograms.decodeState(dec)) return false;
+        }
+        if constexpr (Policy::rolling_windows) {
+            if (!this->rolling_windows.decodeState(dec, windows)) return false;
+        }
+        if constexpr (Policy::model_health) {
+            if (!ModelHealthTable::decodeState(dec, health)) return false;
+        }
+
+        uint64_t countdown = dec.u64();
+        uint64_t rng = dec.u64();
+        if (!dec.ok() || dec.remaining() != 0 || countdown == 0) return false;
+
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            this->snapshot = restored;
+            if constexpr (Policy::confidence_window) {
+                static_cast<WindowState&>(*this) = std::move(window);
+                this->confidence_samples.reserve(this->window_capacity);
+            }
+            if constexpr (Policy::quantile_sketch) {
+                static_cast<SketchState&>(*this) = std::move(sketch);
+            }
+            if constexpr (Policy::histograms) HistState::copyHistogramsFrom(histograms);
+            if constexpr (Policy::rolling_windows) this->rolling_windows = std::move(windows);
+            if constexpr (Policy::model_health) this->model_health.restore(health);
+            this->sample_countdown = countdown;
+            this->sampling_rng = rng;
+            this->overflow_flag.store(restored.overflow_detected);
+            recomputeStatistics();
         }
-        
         return true;
     }
 
-    // Circular buffer management
-    void addConfidenceSample(float confidence) {
-        if (confidence_samples.size() < MAX_SAMPLES) {
-            confidence_samples.push_back(confidence);
+    bool loadState(const std::vector<uint8_t>& data) {
+        return loadState(data.data(), data.size());
+    }
+
+private:
+    // Same clock the engine stamps Decision::timestamp_ns with
+    static uint64_t currentTimestampNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // observeDecision() for policies with counters
+    void recordDecision(const Decision& d, uint64_t latency_ns) {
+        if constexpr (Policy::enabled) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+
+            // Input validation
+            if (!isValidDecision(d)) {
+                this->snapshot.invalid_inputs++;
+                if constexpr (Policy::rolling_windows) this->rolling_windows.observe(d, false);
+                return;
+            }
+
+            // Overflow protection
+            if (this->snapshot.total_decisions == UINT64_MAX) {
+                this->overflow_flag.store(true);
+                this->snapshot.overflow_detected = true;
+                return;
+            }
+
+            this->snapshot.total_decisions++;
+            this->snapshot.last_decision_timestamp_ns = d.timestamp_ns;
+
+            // Status tracking. Only decisions that produced a value (valid or
+            // fallback) move the regime tracker.
+            bool fallback = false;
+            bool regime = true;
+            switch (d.status) {
+                case DECISION_VALID:
+                    this->snapshot.valid_decisions++;
+                    break;
+                case REJECTED_LOW_CONFIDENCE:
+                    this->snapshot.rejected_confidence++;
+                    this->snapshot.fallback_activations++;
+                    fallback = true;
+                    break;
+                case REJECTED_NO_CONSENSUS:
+                    this->snapshot.rejected_consensus++;
+                    this->snapshot.fallback_activations++;
+                    fallback = true;
+                    break;
+                case FALLBACK_ACTIVATED:
+                    this->snapshot.fallback_activations++;
+                    fallback = true;
+                    break;
+                case ERROR_NO_MODELS:
+                    regime = false;
+                    break;
+                default:
+                    // Unknown status - log but don't crash
+                    regime = false;
+                    break;
+            }
+            if (regime) {
+                this->snapshot.fallback_regimes.record(fallback, d.timestamp_ns,
+                                                       this->config.max_regime_gap_ns);
+            }
+
+            // Histogram tracking (values above MAX_MODELS go to overflow)
+            this->snapshot.models_agreed_histogram.record(d.models_agreed);
+
+            if constexpr (Policy::rolling_windows) this->rolling_windows.observe(d, true);
+
+            if (latency_ns == 0) latency_ns = d.latency_ns;
+            if (histogramsEnabled() && latency_ns > 0) {
+                recordLatency(d.status, latency_ns);
+            }
+
+            // Everything below runs on sampled decisions only
+            if (--this->sample_countdown > 0) return;
+            this->sample_countdown = nextSampleGap();
+            this->snapshot.sampled_decisions++;
+
+            // Circular buffer management (bounded memory)
+            if constexpr (Policy::confidence_window) this->addConfidenceSample(d.confidence);
+            if constexpr (Policy::quantile_sketch) {
+                if (this->config.quantile_sketch_k > 0) this->confidence_sketch.update(d.confidence);
+            }
+
+            if constexpr (Policy::histograms) {
+                if (this->config.enable_histograms) {
+                    this->confidence_histogram.record(d.confidence);
+                    this->final_value_histogram.record(d.final_value);
+                }
+            }
+
+            recomputeStatistics();
+        }
+    }
+
+    // The configuration in effect; defaults for the Null policy, which
+    // stores none
+    MetricsConfig activeConfig() const {
+        if constexpr (Policy::enabled) return this->config;
+        return MetricsConfig();
+    }
+
+    // Compile-time false when the policy drops histograms
+    bool histogramsEnabled() const {
+        if constexpr (Policy::enabled && Policy::histograms) return this->config.enable_histograms;
+        return false;
+    }
+
+    void recordLatency(DecisionStatus status, uint64_t latency_ns) {
+        if constexpr (Policy::histograms) HistState::recordLatency(status, latency_ns);
+    }
+
+    // 1 for deterministic sampling's every-Nth; otherwise a geometric gap
+    // with mean N, so each decision is sampled independently with p = 1/N
+    uint64_t nextSampleGap() {
+        if constexpr (!Policy::enabled) {
+            return 1;
         } else {
-            samples_buffer_full = true;
-            confidence_samples[sample_write_index] = confidence;
-            sample_write_index = (sample_write_index + 1) % MAX_SAMPLES;
+            uint32_t n = this->config.sample_every;
+            if (n <= 1) return 1;
+            if (!this->config.random_sampling) return n;
+
+            this->sampling_rng ^= this->sampling_rng << 13;
+            this->sampling_rng ^= this->sampling_rng >> 7;
+            this->sampling_rng ^= this->sampling_rng << 17;
+            double u = (static_cast<double>(this->sampling_rng >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+            double gap = std::floor(std::log(u) / std::log1p(-1.0 / n));
+            return 1 + static_cast<uint64_t>(std::min(gap, 1e15));
         }
     }
 
-    // Recompute derived statistics
-    void recomputeStatistics() {
-        if (snapshot.total_decisions == 0) return;
-
-        // Rates
-        snapshot.fallback_rate =
-            static_cast<float>(snapshot.fallback_activations) /
-            static_cast<float>(snapshot.total_decisions);
-
-        snapshot.consensus_failure_rate =
-            static_cast<float>(snapshot.rejected_consensus) /
-            static_cast<float>(snapshot.total_decisions);
-
-        // Confidence statistics
-        if (confidence_samples.empty()) {
-            snapshot.average_confidence = 0.0f;
-            snapshot.min_confidence = 0.0f;
-            snapshot.max_confidence = 0.0f;
-            snapshot.stddev_confidence = 0.0f;
+    // Rates come from the exact counters, not the sampled statistics
+    static float fallbackRate(const MetricsSnapshot& m) {
+        return m.total_decisions
+                   ? static_cast<float>(m.fallback_activations) / m.total_decisions
+                   : 0.0f;
+    }
+
+    // Scale sampled distribution totals and attach error bounds
+    static void applySampling(MetricsSnapshot& out, size_t window_samples, uint32_t sample_every) {
+        out.fallback_rate = fallbackRate(out);
+        out.consensus_failure_rate =
+            out.total_decisions
+                ? static_cast<float>(out.rejected_consensus) / out.total_decisions
+                : 0.0f;
+
+        if (sample_every <= 1 || out.sampled_decisions == 0) {
+            out.sampling_rate = 1.0f;
             return;
         }
 
-        // Mean
-        double sum = std::accumulate(
-            confidence_samples.begin(),
-            confidence_samples.end(),
-            0.0
-        );
-        snapshot.average_confidence = 
-            static_cast<float>(sum / confidence_samples.size());
-
-        // Min/Max
-        auto minmax = std::minmax_element(
-            confidence_samples.begin(),
-            confidence_samples.end()
-        );
-        snapshot.min_confidence = *minmax.first;
-        snapshot.max_confidence = *minmax.second;
-
-        // Standard deviation (using Welford's online algorithm concept)
-        double mean = snapshot.average_confidence;
-        double sq_sum = 0.0;
-        for (float val : confidence_samples) {
-            double diff = val - mean;
-            sq_sum += diff * diff;
-        }
-        snapshot.stddev_confidence = 
-            static_cast<float>(std::sqrt(sq_sum / confidence_samples.size()));
+        // Realized rate (Horvitz-Thompson with the observed inclusion ratio)
+        double rate = static_cast<double>(out.sampled_decisions) / out.total_decisions;
+        double scale = 1.0 / rate;
+        out.sampling_rate = static_cast<float>(rate);
+        PercentileSummary* sampled[] = {&out.confidence_percentiles,
+                                        &out.final_value_percentiles};
+        for (PercentileSummary* p : sampled) {
+            p->count = static_cast<uint64_t>(std::llround(p->count * scale));
+            p->sum *= scale;
+        }
+
+        // 95% half-widths with finite-population correction sqrt(1 - rate)
+        // (window mean vs. lifetime distributions; rank error at the median,
+        // its worst case: 1.96 * sqrt(0.25 / n))
+        double fpc = std::sqrt(std::max(0.0, 1.0 - rate));
+        if (window_samples > 0) {
+            double n = static_cast<double>(window_samples);
+            out.average_confidence_error =
+                static_cast<float>(1.96 * out.stddev_confidence / std::sqrt(n) * fpc);
+        }
+        out.confidence_rank_error = static_cast<float>(
+            0.98 / std::sqrt(static_cast<double>(out.sampled_decisions)) * fpc);
+    }
+
+    static void encodeRegimes(StateEncoder& enc, const FallbackRegimes& r) {
+        enc.u32(r.in_fallback ? 1u : 0u);
+        enc.u64(r.current_streak);
+        enc.u64(r.current_streak_ns);
+        enc.u64(r.longest_fallback_streak);
+        enc.u64(r.longest_normal_streak);
+        enc.u64(r.fallback_episodes);
+        enc.u32(FallbackRegimes::STREAK_BUCKETS);
+        for (uint64_t b : r.fallback_streak_log2) enc.u64(b);
+        for (uint64_t b : r.normal_streak_log2) enc.u64(b);
+        enc.u64(r.time_in_fallback_ns);
+        enc.u64(r.time_in_normal_ns);
+        enc.u64(r.last_timestamp_ns);
+    }
+
+    static bool decodeRegimes(StateDecoder& dec, FallbackRegimes& r) {
+        r.in_fallback = dec.u32() != 0;
+        r.current_streak = dec.u64();
+        r.current_streak_ns = dec.u64();
+        r.longest_fallback_streak = dec.u64();
+        r.longest_normal_streak = dec.u64();
+        r.fallback_episodes = dec.u64();
+        if (dec.u32() != FallbackRegimes::STREAK_BUCKETS) return false;
+        for (uint64_t& b : r.fallback_streak_log2) b = dec.u64();
+        for (uint64_t& b : r.normal_streak_log2) b = dec.u64();
+        r.time_in_fallback_ns = dec.u64();
+        r.time_in_normal_ns = dec.u64();
+        r.last_timestamp_ns = dec.u64();
+        return dec.ok();
+    }
+
+    // Fingerprint of the policy and configuration that shape the
+    // checkpointed state
+    uint64_t layoutFingerprint() const {
+        const MetricsConfig cfg = activeConfig();
+        std::vector<uint8_t> layout;
+        StateEncoder enc(layout);
+        enc.u32((Policy::confidence_window ? 1u : 0u) | (Policy::quantile_sketch ? 2u : 0u) |
+                (Policy::histograms ? 4u : 0u) | (Policy::rolling_windows ? 8u : 0u) |
+                (Policy::model_health ? 16u : 0u));
+        enc.u64(cfg.confidence_window);
+        enc.u32(static_cast<uint32_t>(cfg.quantile_sketch_k));
+        enc.u32(cfg.enable_histograms ? 1u : 0u);
+        enc.u32(static_cast<uint32_t>(cfg.histogram_precision_bits));
+        enc.f64(cfg.max_tracked_value);
+        enc.f64(cfg.latency_resolution_ns);
+        enc.f64(cfg.max_tracked_latency_ns);
+        enc.u32(static_cast<uint32_t>(cfg.latency_precision_bits));
+        enc.u32(cfg.latency_by_status ? 1u : 0u);
+        enc.u32(cfg.sample_every);
+        enc.u32(cfg.random_sampling ? 1u : 0u);
+        enc.u32(DECISION_STATUS_COUNT);
+        return stateChecksum(layout.data(), layout.size());
+    }
+
+    // Input validation
+    bool isValidDecision(const Decision& d) const {
+        return isObservableDecision(d);
+    }
+
+    size_t samplesInWindow() const {
+        if constexpr (Policy::confidence_window) return WindowState::samplesInWindow();
+        return 0;
+    }
+
+    // Recompute derived statistics (constant time)
+    void recomputeStatistics() {
+        if constexpr (Policy::enabled) {
+            if (this->snapshot.total_decisions == 0) return;
+
+            // Rates
+            this->snapshot.fallback_rate =
+                static_cast<float>(this->snapshot.fallback_activations) /
+                static_cast<float>(this->snapshot.total_decisions);
+
+            this->snapshot.consensus_failure_rate =
+                static_cast<float>(this->snapshot.rejected_consensus) /
+                static_cast<float>(this->snapshot.total_decisions);
+
+            // Confidence statistics
+            if constexpr (Policy::confidence_window) this->fillConfidenceStatistics(this->snapshot);
+        }
     }
 };
 
+// The full-featured collector every exporter and helper in this directory
+// takes; the reduced policies are for deployments that only count
+using MetricsCollector = BasicMetricsCollector<FullMetricsPolicy>;
+using CountersOnlyMetricsCollector = BasicMetricsCollector<CountersOnlyMetricsPolicy>;
+using NullMetricsCollector = BasicMetricsCollector<NullMetricsPolicy>;
+
 // ============================================================================
 // OPTIONAL HELPER: HUMAN-READABLE SUMMARY
 // ============================================================================
@@ -269,8 +2100,56 @@ inline std::string formatMetrics(const MetricsSnapshot& m) {
     out += "  Min:     " + std::to_string(m.min_confidence) + "\n";
     out += "  Max:     " + std::to_string(m.max_confidence) + "\n";
     out += "  StdDev:  " + std::to_string(m.stddev_confidence) + "\n";
+    if (m.sampling_rate < 1.0f) {
+        out += "  Sampled: " + std::to_string(m.sampled_decisions) + " (rate " +
+               std::to_string(m.sampling_rate) + ", average +/- " +
+               std::to_string(m.average_confidence_error) + ")\n";
+    }
     out += "\n";
+
+    auto percentiles = [&out](const char* label, const PercentileSummary& p,
+                              const char* suffix) {
+        if (p.count == 0) return;
+        out += std::string("  ") + label +
+               " p50=" + std::to_string(p.p50) + suffix +
+               " p90=" + std::to_string(p.p90) + suffix +
+               " p99=" + std::to_string(p.p99) + suffix +
+               " p99.9=" + std::to_string(p.p999) + suffix + "\n";
+    };
+    if (m.confidence_percentiles.count > 0) {
+        out += "Distributions:\n";
+        percentiles("Confidence: ", m.confidence_percentiles, "");
+        percentiles("Final Value:", m.final_value_percentiles, "");
+        percentiles("Latency:    ", m.latency_ns_percentiles, "ns");
+        out += "\n";
+    }
+    bool by_status = false;
+    for (const PercentileSummary& p : m.latency_ns_by_status) by_status |= p.count > 0;
+    if (by_status) {
+        out += "Latency by Status:\n";
+        for (int i = 0; i < DECISION_STATUS_COUNT; ++i) {
+            if (m.latency_ns_by_status[i].count == 0) continue;
+            std::string label = decisionStatusLabel(static_cast<DecisionStatus>(i));
+            label.resize(20, ' ');
+            percentiles(label.c_str(), m.latency_ns_by_status[i], "ns");
+        }
+        out += "\n";
+    }
     
+    const FallbackRegimes& r = m.fallback_regimes;
+    if (r.current_streak > 0) {
+        out += "Fallback Regimes:\n";
+        out += std::string("  Current: ") + (r.in_fallback ? "fallback" : "normal") +
+               " for " + std::to_string(r.current_streak) + " decisions (" +
+               std::to_string(r.currentStreakNs() / 1e6) + " ms)\n";
+        out += "  Longest Fallback Streak: " + std::to_string(r.longest_fallback_streak) + "\n";
+        out += "  Longest Normal Streak:   " + std::to_string(r.longest_normal_streak) + "\n";
+        out += "  Fallback Episodes: " + std::to_string(r.fallback_episodes) + " (mean " +
+               std::to_string(r.meanFallbackStreak(m.fallback_activations)) + " decisions)\n";
+        out += "  Time in Fallback: " + std::to_string(r.fallbackTimeFraction() * 100.0f) + "%\n";
+        out += "\n";
+    }
+
     if (m.overflow_detected) {
         out += "⚠️  WARNING: Counter overflow detected!\n";
     }
@@ -278,6 +2157,21 @@ inline std::string formatMetrics(const MetricsSnapshot& m) {
     return out;
 }
 
+inline std::string formatModelHealth(const std::vector<ModelHealth>& models) {
+    std::string out;
+    out += "Per-Model Health\n";
+    out += "================\n";
+    for (const ModelHealth& h : models) {
+        out += (h.model_id >= 0 ? "Model " + std::to_string(h.model_id) : std::string("Other"));
+        out += ": signals=" + std::to_string(h.signals()) +
+               " pass=" + std::to_string(h.passRate() * 100.0f) + "%" +
+               " grace=" + std::to_string(h.graceRate() * 100.0f) + "%" +
+               " reject=" + std::to_string(h.rejectRate() * 100.0f) + "%" +
+               " disagree=" + std::to_string(h.disagreeRate() * 100.0f) + "%\n";
+    }
+    return out;
+}
+
 } // namespace AILLE
 
 #endif // AILLE_METRICS_HPP
@@ -0,0 +1,227 @@
+/*
+ * AILLE Metrics Extension - Sharded Collector
+ * Contention-free metrics for collectors shared across decision threads
+ *
+ * License: MIT (see LICENSE)
+ *
+ * MetricsCollector serializes every observeDecision() on one mutex.
+ * ShardedMetricsCollector instead gives each thread its own cache-line
+ * aligned shard of relaxed atomic counters; getSnapshot() sums the shards.
+ *
+ * Trade-off: confidence statistics are lifetime (not the 10,000-sample
+ * window of MetricsCollector), and a snapshot taken while writers are
+ * active is a consistent-enough sum of relaxed reads, not a point-in-time
+ * cut across counters.
+ */
+
+#ifndef AILLE_METRICS_SHARDED_HPP
+#define AILLE_METRICS_SHARDED_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// SHARDED METRICS COLLECTOR (LOCK-FREE WRITES)
+// ============================================================================
+
+class ShardedMetricsCollector {
+public:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t DEFAULT_SHARD_COUNT = 64;
+    static constexpr int HISTOGRAM_BUCKETS = ModelsAgreedHistogram::MAX_MODELS;
+
+private:
+    // Confidence sums are kept in 2^-24 fixed point so they can be
+    // accumulated with integer fetch_add (exact, no CAS loops).
+    static constexpr double FIXED_POINT_SCALE = 16777216.0;
+
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::atomic<uint64_t> total_decisions{0};
+        std::atomic<uint64_t> valid_decisions{0};
+        std::atomic<uint64_t> fallback_activations{0};
+        std::atomic<uint64_t> rejected_confidence{0};
+        std::atomic<uint64_t> rejected_consensus{0};
+        std::atomic<uint64_t> invalid_inputs{0};
+        std::atomic<uint64_t> last_decision_timestamp_ns{0};
+
+        std::atomic<uint64_t> confidence_sum{0};     // fixed point
+        std::atomic<uint64_t> confidence_sum_sq{0};  // fixed point
+
+        // Non-negative IEEE floats order the same as their bit patterns
+        std::atomic<uint32_t> min_confidence_bits{0x7f800000u}; // +inf
+        std::atomic<uint32_t> max_confidence_bits{0};
+
+        std::atomic<uint64_t> models_agreed[HISTOGRAM_BUCKETS + 1] = {};
+        std::atomic<uint64_t> models_agreed_overflow{0};
+    };
+
+    size_t shard_count;
+    std::unique_ptr<Shard[]> shards;
+
+public:
+    explicit ShardedMetricsCollector(size_t shards_requested = DEFAULT_SHARD_COUNT)
+        : shard_count(std::max<size_t>(1, shards_requested)),
+          shards(new Shard[std::max<size_t>(1, shards_requested)]) {}
+
+    ShardedMetricsCollector(const ShardedMetricsCollector&) = delete;
+    ShardedMetricsCollector& operator=(const ShardedMetricsCollector&) = delete;
+
+    // Called externally after each decision; never blocks
+    void observeDecision(const Decision& d) {
+        Shard& s = shards[threadSlot() % shard_count];
+
+        if (!isObservableDecision(d)) {
+            s.invalid_inputs.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        s.total_decisions.fetch_add(1, std::memory_order_relaxed);
+        s.last_decision_timestamp_ns.store(d.timestamp_ns, std::memory_order_relaxed);
+
+        switch (d.status) {
+            case DECISION_VALID:
+                s.valid_decisions.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case REJECTED_LOW_CONFIDENCE:
+                s.rejected_confidence.fetch_add(1, std::memory_order_relaxed);
+                s.fallback_activations.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case REJECTED_NO_CONSENSUS:
+                s.rejected_consensus.fetch_add(1, std::memory_order_relaxed);
+                s.fallback_activations.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case FALLBACK_ACTIVATED:
+                s.fallback_activations.fetch_add(1, std::memory_order_relaxed);
+                break;
+            default:
+                break;
+        }
+
+        double c = d.confidence;
+        s.confidence_sum.fetch_add(
+            static_cast<uint64_t>(c * FIXED_POINT_SCALE), std::memory_order_relaxed);
+        s.confidence_sum_sq.fetch_add(
+            static_cast<uint64_t>(c * c * FIXED_POINT_SCALE), std::memory_order_relaxed);
+
+        uint32_t bits;
+        std::memcpy(&bits, &d.confidence, sizeof(bits));
+        bits &= 0x7fffffffu; // fold -0.0f onto +0.0f
+        atomicMin(s.min_confidence_bits, bits);
+        atomicMax(s.max_confidence_bits, bits);
+
+        if (d.models_agreed <= HISTOGRAM_BUCKETS) {
+            s.models_agreed[d.models_agreed].fetch_add(1, std::memory_order_relaxed);
+        } else {
+            s.models_agreed_overflow.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Sum across shards
+    MetricsSnapshot getSnapshot() const {
+        MetricsSnapshot out;
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        uint32_t min_bits = 0x7f800000u;
+        uint32_t max_bits = 0;
+
+        for (size_t i = 0; i < shard_count; ++i) {
+            const Shard& s = shards[i];
+            out.total_decisions += s.total_decisions.load(std::memory_order_relaxed);
+            out.valid_decisions += s.valid_decisions.load(std::memory_order_relaxed);
+            out.fallback_activations += s.fallback_activations.load(std::memory_order_relaxed);
+            out.rejected_confidence += s.rejected_confidence.load(std::memory_order_relaxed);
+            out.rejected_consensus += s.rejected_consensus.load(std::memory_order_relaxed);
+            out.invalid_inputs += s.invalid_inputs.load(std::memory_order_relaxed);
+            out.last_decision_timestamp_ns = std::max(
+                out.last_decision_timestamp_ns,
+                s.last_decision_timestamp_ns.load(std::memory_order_relaxed));
+
+            sum += static_cast<double>(s.confidence_sum.load(std::memory_order_relaxed));
+            sum_sq += static_cast<double>(s.confidence_sum_sq.load(std::memory_order_relaxed));
+            min_bits = std::min(min_bits, s.min_confidence_bits.load(std::memory_order_relaxed));
+            max_bits = std::max(max_bits, s.max_confidence_bits.load(std::memory_order_relaxed));
+
+            ModelsAgreedHistogram& h = out.models_agreed_histogram;
+            for (int b = 0; b <= HISTOGRAM_BUCKETS; ++b) {
+                h.buckets[b] += s.models_agreed[b].load(std::memory_order_relaxed);
+            }
+            h.overflow += s.models_agreed_overflow.load(std::memory_order_relaxed);
+        }
+
+        if (out.total_decisions == 0) return out;
+
+        double n = static_cast<double>(out.total_decisions);
+        out.fallback_rate = static_cast<float>(out.fallback_activations / n);
+        out.consensus_failure_rate = static_cast<float>(out.rejected_consensus / n);
+
+        double mean = sum / FIXED_POINT_SCALE / n;
+        double variance = sum_sq / FIXED_POINT_SCALE / n - mean * mean;
+        out.average_confidence = static_cast<float>(mean);
+        out.stddev_confidence = static_cast<float>(std::sqrt(std::max(variance, 0.0)));
+        std::memcpy(&out.min_confidence, &min_bits, sizeof(min_bits));
+        std::memcpy(&out.max_confidence, &max_bits, sizeof(max_bits));
+
+        return out;
+    }
+
+    bool isHealthy(float max_fallback_rate = 0.10f) const {
+        return getSnapshot().fallback_rate <= max_fallback_rate;
+    }
+
+    // Not linearizable with concurrent observeDecision() calls
+    void reset() {
+        for (size_t i = 0; i < shard_count; ++i) {
+            Shard& s = shards[i];
+            s.total_decisions.store(0, std::memory_order_relaxed);
+            s.valid_decisions.store(0, std::memory_order_relaxed);
+            s.fallback_activations.store(0, std::memory_order_relaxed);
+            s.rejected_confidence.store(0, std::memory_order_relaxed);
+            s.rejected_consensus.store(0, std::memory_order_relaxed);
+            s.invalid_inputs.store(0, std::memory_order_relaxed);
+            s.last_decision_timestamp_ns.store(0, std::memory_order_relaxed);
+            s.confidence_sum.store(0, std::memory_order_relaxed);
+            s.confidence_sum_sq.store(0, std::memory_order_relaxed);
+            s.min_confidence_bits.store(0x7f800000u, std::memory_order_relaxed);
+            s.max_confidence_bits.store(0, std::memory_order_relaxed);
+            for (auto& b : s.models_agreed) b.store(0, std::memory_order_relaxed);
+            s.models_agreed_overflow.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    size_t getShardCount() const { return shard_count; }
+
+private:
+    // Each thread gets a stable slot the first time it observes a decision
+    static size_t threadSlot() {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    static void atomicMin(std::atomic<uint32_t>& target, uint32_t value) {
+        uint32_t cur = target.load(std::memory_order_relaxed);
+        while (value < cur &&
+               !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void atomicMax(std::atomic<uint32_t>& target, uint32_t value) {
+        uint32_t cur = target.load(std::memory_order_relaxed);
+        while (value > cur &&
+               !target.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_METRICS_SHARDED_HPP
@@ -0,0 +1,371 @@
+/*
+ * AILLE Metrics Extension - Pairwise Model Agreement
+ * Streaming M x M sign-agreement and covariance matrices
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Attached to the engine as a DecisionObserver, ModelAgreementMatrix sees
+ * the raw input signals of every decision and maintains, for each pair of
+ * model ids (i, j) that appeared together:
+ *
+ *   - how often their values agreed in sign
+ *   - the covariance and correlation of their values
+ *
+ * so ensemble redundancy can be read at runtime instead of exporting every
+ * signal for offline analysis.
+ *
+ * Each decision is a set of rank-1 updates over five M x M planes
+ * (co-occurrence m m', sign products s s', cross products x x', and the
+ * pairwise sums x m' and x^2 m'). Absent models contribute zero rows, so only
+ * rows of models present in the decision are touched; each row update is one
+ * fused, contiguous loop the compiler vectorizes. Exponential windowing uses
+ * a growing update weight instead of decaying every cell, so it costs
+ * nothing per decision (planes are renormalized once the weight gets large).
+ *
+ * Readers never touch the accumulators: every publish_every updates the
+ * planes are copied into the inactive half of a double buffer (the same
+ * per-slot seqlock scheme as PublishedSnapshot), and read() copies the
+ * latest one without blocking the updater.
+ */
+
+#ifndef AILLE_MODEL_AGREEMENT_HPP
+#define AILLE_MODEL_AGREEMENT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+#include "aille.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define AILLE_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define AILLE_RESTRICT __restrict
+#else
+#define AILLE_RESTRICT
+#endif
+
+namespace AILLE {
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+struct ModelAgreementConfig {
+    int max_models;                    // Default: 16 (ids 0..15; others are ignored)
+    uint64_t window_decisions;         // Default: 0 (cumulative; N = ~N-decision EWMA window)
+    uint32_t publish_every;            // Default: 64 updates between published matrices
+
+    ModelAgreementConfig()
+        : max_models(16),
+          window_decisions(0),
+          publish_every(64) {}
+};
+
+// ============================================================================
+// PAIR STATISTICS / SNAPSHOT
+// ============================================================================
+
+struct ModelPairStats {
+    int model_a = -1;
+    int model_b = -1;
+    double weight = 0.0;               // (decayed) decisions where both appeared
+    double agreement_rate = 0.0;       // fraction with the same sign
+    double mean_a = 0.0;               // over those decisions
+    double mean_b = 0.0;
+    double covariance = 0.0;           // population covariance of the values
+    double correlation = 0.0;          // 0 when either side has no variance
+};
+
+// Published copy of the accumulators; reuse one per reader to avoid
+// reallocating on every read()
+class ModelAgreementSnapshot {
+public:
+    enum Plane { PAIRS, SIGNS, CROSS, SUMS, SQUARES, PLANE_COUNT };
+
+    int models = 0;
+    uint64_t updates = 0;              // decisions folded in at publication
+    uint64_t generation = 0;           // 0 = nothing published yet
+    std::vector<double> planes;        // PLANE_COUNT planes of models x models
+
+    double at(Plane p, int i, int j) const {
+        return planes[(static_cast<size_t>(p) * models + i) * models + j];
+    }
+
+    ModelPairStats pair(int a, int b) const {
+        ModelPairStats s;
+        s.model_a = a;
+        s.model_b = b;
+        if (a < 0 || b < 0 || a >= models || b >= models) return s;
+
+        double n = at(PAIRS, a, b);
+        s.weight = n;
+        if (!(n > 0.0)) return s;
+
+        s.agreement_rate = 0.5 * (n + at(SIGNS, a, b)) / n;
+        s.mean_a = at(SUMS, a, b) / n;
+        s.mean_b = at(SUMS, b, a) / n;
+        s.covariance = at(CROSS, a, b) / n - s.mean_a * s.mean_b;
+        double var_a = at(SQUARES, a, b) / n - s.mean_a * s.mean_a;
+        double var_b = at(SQUARES, b, a) / n - s.mean_b * s.mean_b;
+        if (var_a > 0.0 && var_b > 0.0) {
+            s.correlation = std::max(-1.0, std::min(1.0, s.covariance / std::sqrt(var_a * var_b)));
+        }
+        return s;
+    }
+
+    double agreementRate(int a, int b) const { return pair(a, b).agreement_rate; }
+    double correlation(int a, int b) const { return pair(a, b).correlation; }
+};
+
+// ============================================================================
+// STREAMING AGREEMENT MATRIX
+// ============================================================================
+
+class ModelAgreementMatrix : public DecisionObserver {
+private:
+    using Plane = ModelAgreementSnapshot::Plane;
+    static constexpr int PLANE_COUNT = ModelAgreementSnapshot::PLANE_COUNT;
+
+    // Renormalize the planes before the update weight loses headroom
+    static constexpr double MAX_WEIGHT = 1e150;
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        uint64_t updates = 0;
+        std::vector<double> planes;
+    };
+
+    ModelAgreementConfig config;
+    int m;
+    double growth;                     // 1 / decay per update (1 = cumulative)
+
+    // Writer state (protected by update_mtx)
+    mutable std::mutex update_mtx;
+    std::vector<double> acc;           // PLANE_COUNT x m x m
+    std::vector<double> values;        // x, 0 when absent
+    std::vector<double> present;       // m, 1/0
+    std::vector<double> signs;         // s, +-1 or 0 when absent
+    std::vector<int> active;           // ids present in the current decision
+    double weight = 1.0;
+    uint64_t updates = 0;
+    uint64_t ignored_signals = 0;
+
+    // Double-buffered publication
+    Slot slots[2];
+    std::atomic<uint64_t> generation{0};
+
+public:
+    explicit ModelAgreementMatrix(const ModelAgreementConfig& cfg = ModelAgreementConfig())
+        : config(cfg),
+          m(std::max(1, cfg.max_models)),
+          growth(cfg.window_decisions > 1 ? 1.0 / (1.0 - 1.0 / cfg.window_decisions) : 1.0),
+          acc(static_cast<size_t>(PLANE_COUNT) * m * m, 0.0),
+          values(m, 0.0),
+          present(m, 0.0),
+          signs(m, 0.0) {
+        config.publish_every = std::max<uint32_t>(1, config.publish_every);
+        active.reserve(m);
+        for (Slot& s : slots) s.planes.assign(acc.size(), 0.0);
+    }
+
+    ModelAgreementMatrix(const ModelAgreementMatrix&) = delete;
+    ModelAgreementMatrix& operator=(const ModelAgreementMatrix&) = delete;
+
+    // DecisionObserver: raw signals from makeDecision()
+    void onSignals(const std::vector<ModelSignal>& signals) override { observe(signals); }
+
+    // Folds one decision's signals in: O(k * M) for k models present
+    void observe(const std::vector<ModelSignal>& signals) {
+        std::lock_guard<std::mutex> lock(update_mtx);
+
+        active.clear();
+        for (const ModelSignal& sig : signals) {
+            int id = sig.model_id;
+            if (id < 0 || id >= m || !std::isfinite(sig.value)) {
+                ignored_signals++;
+                continue;
+            }
+            if (present[id] == 0.0) active.push_back(id);
+            present[id] = 1.0;
+            values[id] = sig.value;
+            signs[id] = (sig.value >= 0) ? 1.0 : -1.0;
+        }
+
+        if (growth != 1.0) {
+            weight *= growth;
+            if (weight > MAX_WEIGHT) renormalize();
+        }
+
+        const size_t plane = static_cast<size_t>(m) * m;
+        for (int i : active) {
+            double w = weight;
+            double xi = values[i] * w;
+            double si = signs[i] * w;
+            double qi = values[i] * values[i] * w;
+            rowUpdate(&acc[0 * plane + static_cast<size_t>(i) * m],
+                      &acc[1 * plane + static_cast<size_t>(i) * m],
+                      &acc[2 * plane + static_cast<size_t>(i) * m],
+                      &acc[3 * plane + static_cast<size_t>(i) * m],
+                      &acc[4 * plane + static_cast<size_t>(i) * m],
+                      present.data(), signs.data(), values.data(), w, si, xi, qi, m);
+        }
+
+        for (int i : active) {
+            present[i] = 0.0;
+            values[i] = 0.0;
+            signs[i] = 0.0;
+        }
+
+        if (++updates % config.publish_every == 0) publishLocked();
+    }
+
+    // Publishes the current accumulators immediately
+    void publish() {
+        std::lock_guard<std::mutex> lock(update_mtx);
+        publishLocked();
+    }
+
+    // Copies the latest published matrices without blocking the updater.
+    // Returns the generation (0 = nothing published yet).
+    uint64_t read(ModelAgreementSnapshot& out) const {
+        out.models = m;
+        out.planes.resize(acc.size());
+        while (true) {
+            uint64_t g = generation.load(std::memory_order_acquire);
+            if (g == 0) {
+                std::fill(out.planes.begin(), out.planes.end(), 0.0);
+                out.updates = 0;
+                out.generation = 0;
+                return 0;
+            }
+            const Slot& slot = slots[g & 1];
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            std::memcpy(out.planes.data(), slot.planes.data(), out.planes.size() * sizeof(double));
+            uint64_t slot_updates = slot.updates;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                out.updates = slot_updates;
+                out.generation = g;
+                return g;
+            }
+        }
+    }
+
+    ModelAgreementSnapshot getSnapshot() const {
+        ModelAgreementSnapshot s;
+        read(s);
+        return s;
+    }
+
+    // All pairs that appeared together, most correlated first
+    std::vector<ModelPairStats> getPairs() const {
+        ModelAgreementSnapshot s = getSnapshot();
+        std::vector<ModelPairStats> out;
+        for (int a = 0; a < m; ++a) {
+            for (int b = a + 1; b < m; ++b) {
+                ModelPairStats p = s.pair(a, b);
+                if (p.weight > 0.0) out.push_back(p);
+            }
+        }
+        std::sort(out.begin(), out.end(), [](const ModelPairStats& x, const ModelPairStats& y) {
+            return std::fabs(x.correlation) > std::fabs(y.correlation);
+        });
+        return out;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(update_mtx);
+        std::fill(acc.begin(), acc.end(), 0.0);
+        weight = 1.0;
+        updates = 0;
+        ignored_signals = 0;
+        publishLocked();
+    }
+
+    int getMaxModels() const { return m; }
+    uint64_t getPublishedGeneration() const { return generation.load(std::memory_order_acquire); }
+
+    uint64_t getUpdateCount() const {
+        std::lock_guard<std::mutex> lock(update_mtx);
+        return updates;
+    }
+
+    // Signals dropped for an out-of-range model_id or non-finite value
+    uint64_t getIgnoredSignals() const {
+        std::lock_guard<std::mutex> lock(update_mtx);
+        return ignored_signals;
+    }
+
+private:
+    // One row of each plane: contiguous, non-aliasing, no branches
+    static void rowUpdate(double* AILLE_RESTRICT pairs, double* AILLE_RESTRICT sgn,
+                          double* AILLE_RESTRICT cross, double* AILLE_RESTRICT sums,
+                          double* AILLE_RESTRICT squares,
+                          const double* AILLE_RESTRICT mask, const double* AILLE_RESTRICT s,
+                          const double* AILLE_RESTRICT x,
+                          double w, double si, double xi, double qi, int n) {
+        for (int j = 0; j < n; ++j) {
+            pairs[j] += w * mask[j];
+            sgn[j] += si * s[j];
+            cross[j] += xi * x[j];
+            sums[j] += xi * mask[j];
+            squares[j] += qi * mask[j];
+        }
+    }
+
+    void renormalize() {
+        double inv = 1.0 / weight;
+        for (double& v : acc) v *= inv;
+        weight = 1.0;
+    }
+
+    // Writes normalized planes (true decayed counts) to the inactive slot
+    void publishLocked() {
+        uint64_t next = generation.load(std::memory_order_relaxed) + 1;
+        Slot& slot = slots[next & 1];
+        uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        double inv = 1.0 / weight;
+        const double* AILLE_RESTRICT src = acc.data();
+        double* AILLE_RESTRICT dst = slot.planes.data();
+        for (size_t k = 0; k < acc.size(); ++k) dst[k] = src[k] * inv;
+        slot.updates = updates;
+
+        slot.sequence.store(seq + 2, std::memory_order_release);
+        generation.store(next, std::memory_order_release);
+    }
+};
+
+// ============================================================================
+// OPTIONAL HELPER: HUMAN-READABLE SUMMARY
+// ============================================================================
+
+inline std::string formatModelAgreement(const std::vector<ModelPairStats>& pairs,
+                                        size_t max_pairs = 20) {
+    std::string out;
+    out += "Model Agreement (top pairs by |correlation|)\n";
+    out += "============================================\n";
+    size_t shown = 0;
+    for (const ModelPairStats& p : pairs) {
+        if (shown++ == max_pairs) break;
+        out += "  " + std::to_string(p.model_a) + " ~ " + std::to_string(p.model_b) +
+               ": agree=" + std::to_string(p.agreement_rate * 100.0) + "%" +
+               " corr=" + std::to_string(p.correlation) +
+               " cov=" + std::to_string(p.covariance) +
+               " n=" + std::to_string(p.weight) + "\n";
+    }
+    return out;
+}
+
+} // namespace AILLE
+
+#endif // AILLE_MODEL_AGREEMENT_HPP
@@ -0,0 +1,343 @@
+/*
+ * AILLE Extension - Hardware Performance Counter Probes
+ * Explain why a call is slow, not just that it is
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Wraps any block of code (makeDecision, logDecision, observeDecision, or
+ * a caller's own loop) in Linux perf_event_open counters and reports
+ * per-operation instructions, cycles, IPC, L1D and last-level cache
+ * misses, branch misses and page faults:
+ *
+ *   AILLE::PerfCounters counters;              // open once (syscalls)
+ *   {
+ *       AILLE::PerfCounters::Scope scope(counters, n);
+ *       for (int i = 0; i < n; ++i) engine.makeDecision(signals[i]);
+ *   }
+ *   AILLE::PerfReading r = counters.reading();  // r.perOp(PERF_CYCLES), r.ipc()
+ *
+ * Only user-space events are requested, which perf_event_paranoid <= 2
+ * allows without privileges. The hardware events are opened as one group
+ * led by cycles, so the kernel schedules them together and ratios such as
+ * ipc() compare counts from the same time slices; the group is read in a
+ * single read() and scaled by its time_enabled / time_running when the
+ * kernel multiplexes counters. An event that cannot join the group (or
+ * every event, when cycles itself cannot be opened) falls back to its own
+ * counter, so a host that exposes some counters (containers and VMs often
+ * only offer the software page-fault counter) still reports those; the
+ * rest read as unavailable, and unavailableReason() says why.
+ *
+ * Linux only; elsewhere every event is unavailable. Not thread-safe; the
+ * counters follow the thread that constructed them.
+ */
+
+#ifndef AILLE_PERF_COUNTERS_HPP
+#define AILLE_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define AILLE_HAS_PERF_EVENTS 1
+#endif
+
+namespace AILLE {
+
+// ============================================================================
+// EVENTS AND READINGS
+// ============================================================================
+
+enum PerfEvent {
+    PERF_INSTRUCTIONS = 0,
+    PERF_CYCLES,
+    PERF_L1D_MISSES,                   // L1 data cache read misses
+    PERF_LLC_MISSES,                   // last-level cache misses
+    PERF_BRANCH_MISSES,
+    PERF_PAGE_FAULTS,
+    PERF_EVENT_COUNT
+};
+
+inline const char* perfEventName(int e) {
+    switch (e) {
+        case PERF_INSTRUCTIONS:  return "instructions";
+        case PERF_CYCLES:        return "cycles";
+        case PERF_L1D_MISSES:    return "l1d_misses";
+        case PERF_LLC_MISSES:    return "llc_misses";
+        case PERF_BRANCH_MISSES: return "branch_misses";
+        case PERF_PAGE_FAULTS:   return "page_faults";
+        default:                 return "unknown";
+    }
+}
+
+// Totals accumulated over every Scope since the last reset()
+struct PerfReading {
+    double count[PERF_EVENT_COUNT] = {};
+    bool available[PERF_EVENT_COUNT] = {};
+    uint64_t operations = 0;
+    double elapsed_ns = 0.0;
+
+    bool has(int e) const { return available[e]; }
+    bool anyAvailable() const {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (available[e]) return true;
+        }
+        return false;
+    }
+
+    // Per-operation value; 0 when unavailable or nothing was measured
+    double perOp(int e) const {
+        return (available[e] && operations > 0) ? count[e] / static_cast<double>(operations)
+                                                : 0.0;
+    }
+    double nsPerOp() const {
+        return operations > 0 ? elapsed_ns / static_cast<double>(operations) : 0.0;
+    }
+
+    // Instructions per cycle; 0 unless both counters are available
+    double ipc() const {
+        if (!available[PERF_INSTRUCTIONS] || !available[PERF_CYCLES] || count[PERF_CYCLES] <= 0.0) {
+            return 0.0;
+        }
+        return count[PERF_INSTRUCTIONS] / count[PERF_CYCLES];
+    }
+};
+
+// ============================================================================
+// COUNTER SET
+// ============================================================================
+
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_COUNT];
+    int group_slot[PERF_EVENT_COUNT];  // position in the group read, -1 if separate
+    int group_size = 0;                // leader included; 0 when there is no group
+    PerfReading totals;
+    std::string reason;                // first open failure, if any
+    uint64_t scope_start_ns = 0;
+
+public:
+    PerfCounters() {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            fds[e] = -1;
+            group_slot[e] = -1;
+        }
+        openAll();
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) totals.available[e] = fds[e] >= 0;
+    }
+
+    ~PerfCounters() {
+#ifdef AILLE_HAS_PERF_EVENTS
+        for (int fd : fds) {
+            if (fd >= 0) ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Counts everything between construction and destruction and credits
+    // it to `operations` operations
+    class Scope {
+    private:
+        PerfCounters& counters;
+        uint64_t operations;
+
+    public:
+        Scope(PerfCounters& c, uint64_t ops = 1) : counters(c), operations(ops) {
+            counters.begin();
+        }
+        ~Scope() { counters.end(operations); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Explicit form of Scope for code that cannot nest a block
+    void begin() {
+#ifdef AILLE_HAS_PERF_EVENTS
+        control(PERF_EVENT_IOC_RESET);
+        scope_start_ns = nowNs();
+        control(PERF_EVENT_IOC_ENABLE);
+#else
+        scope_start_ns = nowNs();
+#endif
+    }
+
+    void end(uint64_t operations = 1) {
+#ifdef AILLE_HAS_PERF_EVENTS
+        control(PERF_EVENT_IOC_DISABLE);
+#endif
+        totals.elapsed_ns += static_cast<double>(nowNs() - scope_start_ns);
+        totals.operations += operations;
+#ifdef AILLE_HAS_PERF_EVENTS
+        readGroup();
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fds[e] >= 0 && group_slot[e] < 0) totals.count[e] += readScaled(fds[e]);
+        }
+#endif
+    }
+
+    PerfReading reading() const { return totals; }
+
+    void reset() {
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) totals.count[e] = 0.0;
+        totals.operations = 0;
+        totals.elapsed_ns = 0.0;
+    }
+
+    bool available(int e) const { return totals.available[e]; }
+    bool anyAvailable() const { return totals.anyAvailable(); }
+
+    // True when `e` is counted in the same group as cycles
+    bool grouped(int e) const { return group_slot[e] >= 0; }
+
+    // Empty when every event opened
+    const std::string& unavailableReason() const { return reason; }
+
+private:
+    static uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+#ifdef AILLE_HAS_PERF_EVENTS
+    // Cycles leads the group; the other hardware events join it, and
+    // anything that cannot join (or everything, without a leader) is
+    // opened on its own
+    void openAll() {
+        const uint64_t group_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                      PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const int members[] = {PERF_INSTRUCTIONS, PERF_L1D_MISSES, PERF_LLC_MISSES,
+                               PERF_BRANCH_MISSES};
+
+        int leader = openEvent(PERF_CYCLES, -1, group_format);
+        if (leader >= 0) {
+            fds[PERF_CYCLES] = leader;
+            group_slot[PERF_CYCLES] = group_size++;
+            for (int e : members) {
+                int fd = openEvent(e, leader, group_format);
+                if (fd < 0) continue;
+                fds[e] = fd;
+                group_slot[e] = group_size++;
+            }
+        }
+
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fds[e] >= 0) continue;
+            fds[e] = openEvent(e, -1, PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                          PERF_FORMAT_TOTAL_TIME_RUNNING);
+            if (fds[e] < 0) noteFailure(e);
+        }
+    }
+
+    // Applies a reset/enable/disable to the group (through its leader)
+    // and to every separate event
+    void control(unsigned long request) {
+        if (group_size > 0) ::ioctl(fds[PERF_CYCLES], request, PERF_IOC_FLAG_GROUP);
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (fds[e] >= 0 && group_slot[e] < 0) ::ioctl(fds[e], request, 0);
+        }
+    }
+
+    // Returns the fd, or -1 with errno set; members are enabled with
+    // their leader, so only a leader or separate event starts disabled
+    static int openEvent(int e, int group_fd, uint64_t read_format) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = group_fd < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = read_format;
+
+        switch (e) {
+            case PERF_INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PERF_CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PERF_L1D_MISSES:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case PERF_LLC_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PERF_BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            case PERF_PAGE_FAULTS:
+                attr.type = PERF_TYPE_SOFTWARE;
+                attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+                break;
+            default:
+                errno = EINVAL;
+                return -1;
+        }
+
+        long fd = ::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+        return fd < 0 ? -1 : static_cast<int>(fd);
+    }
+
+    void noteFailure(int e) {
+        if (!reason.empty()) return;
+        int err = errno;
+        reason = std::string(perfEventName(e)) + ": perf_event_open: " + std::strerror(err);
+        if (err == EACCES || err == EPERM) {
+            reason += " (check /proc/sys/kernel/perf_event_paranoid)";
+        } else if (err == ENOENT || err == EOPNOTSUPP) {
+            reason += " (no hardware PMU exposed to this host)";
+        }
+    }
+
+    // One read for the whole group: nr, time_enabled, time_running, then
+    // one value per event in open order, all scaled by the same ratio
+    void readGroup() {
+        if (group_size == 0) return;
+        uint64_t buf[3 + PERF_EVENT_COUNT] = {};
+        ssize_t want = static_cast<ssize_t>((3 + group_size) * sizeof(uint64_t));
+        if (::read(fds[PERF_CYCLES], buf, sizeof(buf)) != want) return;
+        if (buf[0] != static_cast<uint64_t>(group_size) || buf[2] == 0) return;
+        double scale = buf[2] < buf[1] ? static_cast<double>(buf[1]) / static_cast<double>(buf[2])
+                                       : 1.0;
+        for (int e = 0; e < PERF_EVENT_COUNT; ++e) {
+            if (group_slot[e] >= 0) {
+                totals.count[e] += static_cast<double>(buf[3 + group_slot[e]]) * scale;
+            }
+        }
+    }
+
+    // value * enabled / running, so multiplexed counters extrapolate
+    static double readScaled(int fd) {
+        uint64_t buf[3] = {0, 0, 0};   // value, time_enabled, time_running
+        if (::read(fd, buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return 0.0;
+        if (buf[2] == 0) return 0.0;
+        double value = static_cast<double>(buf[0]);
+        if (buf[2] < buf[1]) {
+            value *= static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+        }
+        return value;
+    }
+#else
+    void openAll() { reason = "hardware counters require Linux perf_event_open"; }
+#endif
+};
+
+} // namespace AILLE
+
+#endif // AILLE_PERF_COUNTERS_HPP
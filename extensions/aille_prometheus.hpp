@@ -0,0 +1,396 @@
+/*
+ * AILLE Metrics Extension - Prometheus Exporter
+ * Dependency-free /metrics endpoint on localhost
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Serves MetricsCollector snapshots in Prometheus text format (0.0.4) or
+ * OpenMetrics 1.0 (negotiated via the Accept header) from a background
+ * HTTP/1.1 thread. Each scrape:
+ *
+ *   - takes the collector mutex only to memcpy counters and histogram
+ *     buckets into buffers owned by the exporter (no allocation)
+ *   - computes percentiles and serializes outside the lock into a
+ *     pre-sized buffer that is reused across scrapes
+ *
+ * Distributions are exported as summaries (p50/p90/p99/p99.9, _sum,
+ * _count) rather than ~1000 log-linear buckets per histogram.
+ *
+ * POSIX sockets only; start() returns false on other platforms.
+ */
+
+#ifndef AILLE_PROMETHEUS_HPP
+#define AILLE_PROMETHEUS_HPP
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define AILLE_HAS_POSIX_SOCKETS 1
+#endif
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// TEXT EXPOSITION (PROMETHEUS 0.0.4 / OPENMETRICS 1.0)
+// ============================================================================
+
+class PrometheusWriter {
+private:
+    std::string& out;
+    const char* prefix;
+    bool openmetrics;
+
+    // Formats straight into the tail of `out`. Lines longer than the usual
+    // LINE_RESERVE (long prefixes or label sets) grow the buffer and are
+    // formatted again, never truncated.
+    static constexpr size_t LINE_RESERVE = 256;
+
+    void appendf(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        va_list retry;
+        va_copy(retry, args);
+
+        size_t used = out.size();
+        out.resize(used + LINE_RESERVE);
+        int n = std::vsnprintf(&out[used], LINE_RESERVE, fmt, args);
+        if (n >= static_cast<int>(LINE_RESERVE)) {
+            out.resize(used + static_cast<size_t>(n) + 1);
+            n = std::vsnprintf(&out[used], static_cast<size_t>(n) + 1, fmt, retry);
+        }
+        out.resize(used + static_cast<size_t>(std::max(n, 0)));
+
+        va_end(retry);
+        va_end(args);
+    }
+
+public:
+    PrometheusWriter(std::string& buffer, const char* metric_prefix, bool open_metrics)
+        : out(buffer), prefix(metric_prefix), openmetrics(open_metrics) {}
+
+    // Counter families are named without _total in OpenMetrics metadata
+    void header(const char* name, const char* type, const char* help) {
+        bool counter = std::strcmp(type, "counter") == 0;
+        const char* suffix = (counter && !openmetrics) ? "_total" : "";
+        appendf("# HELP %s_%s%s %s\n", prefix, name, suffix, help);
+        appendf("# TYPE %s_%s%s %s\n", prefix, name, suffix, type);
+    }
+
+    void counter(const char* name, const char* labels, uint64_t value) {
+        appendf("%s_%s_total%s %llu\n", prefix, name, labels,
+                static_cast<unsigned long long>(value));
+    }
+
+    void gauge(const char* name, const char* labels, double value) {
+        appendf("%s_%s%s %.9g\n", prefix, name, labels, value);
+    }
+
+    void summary(const char* name, const char* help, const PercentileSummary& p,
+                 double scale = 1.0) {
+        header(name, "summary", help);
+        summarySamples(name, "", p, scale);
+    }
+
+    // One labeled series of a summary family; `labels` is e.g. status="valid"
+    void summarySamples(const char* name, const char* labels, const PercentileSummary& p,
+                        double scale = 1.0) {
+        const char* sep = labels[0] ? "," : "";
+        const double qs[] = {0.5, 0.9, 0.99, 0.999};
+        const float vs[] = {p.p50, p.p90, p.p99, p.p999};
+        for (int i = 0; i < 4; ++i) {
+            appendf("%s_%s{%s%squantile=\"%g\"} %.9g\n",
+                    prefix, name, labels, sep, qs[i], vs[i] * scale);
+        }
+        const char* open = labels[0] ? "{" : "";
+        const char* close = labels[0] ? "}" : "";
+        appendf("%s_%s_sum%s%s%s %.9g\n", prefix, name, open, labels, close, p.sum * scale);
+        appendf("%s_%s_count%s%s%s %llu\n", prefix, name, open, labels, close,
+                static_cast<unsigned long long>(p.count));
+    }
+
+    void finish() {
+        if (openmetrics) out += "# EOF\n";
+    }
+};
+
+// Appends the exposition of one snapshot to `out` (which the caller may
+// reserve and reuse); usable without the HTTP exporter.
+inline void formatPrometheus(const MetricsSnapshot& m, std::string& out,
+                             bool openmetrics = false, const char* prefix = "aille") {
+    PrometheusWriter w(out, prefix, openmetrics);
+
+    w.header("decisions", "counter", "Decisions observed.");
+    w.counter("decisions", "", m.total_decisions);
+    w.header("decisions_valid", "counter", "Decisions that passed all layers.");
+    w.counter("decisions_valid", "", m.valid_decisions);
+    w.header("fallback_activations", "counter", "Decisions that used the fallback.");
+    w.counter("fallback_activations", "", m.fallback_activations);
+    w.header("rejections", "counter", "Rejected decisions by layer.");
+    w.counter("rejections", "{reason=\"confidence\"}", m.rejected_confidence);
+    w.counter("rejections", "{reason=\"consensus\"}", m.rejected_consensus);
+    w.header("invalid_inputs", "counter", "Decisions rejected by input validation.");
+    w.counter("invalid_inputs", "", m.invalid_inputs);
+
+    w.header("models_agreed", "counter", "Decisions by number of agreeing models.");
+    char labels[48];
+    for (int n = 0; n <= ModelsAgreedHistogram::MAX_MODELS; ++n) {
+        if (m.models_agreed_histogram.buckets[n] == 0) continue;
+        std::snprintf(labels, sizeof(labels), "{models=\"%d\"}", n);
+        w.counter("models_agreed", labels, m.models_agreed_histogram.buckets[n]);
+    }
+    if (m.models_agreed_histogram.overflow > 0) {
+        w.counter("models_agreed", "{models=\"overflow\"}", m.models_agreed_histogram.overflow);
+    }
+
+    w.header("fallback_rate", "gauge", "Fallback activations / decisions.");
+    w.gauge("fallback_rate", "", m.fallback_rate);
+    w.header("consensus_failure_rate", "gauge", "Consensus rejections / decisions.");
+    w.gauge("consensus_failure_rate", "", m.consensus_failure_rate);
+    w.header("confidence", "gauge", "Confidence statistics over the sample window.");
+    w.gauge("confidence", "{stat=\"mean\"}", m.average_confidence);
+    w.gauge("confidence", "{stat=\"min\"}", m.min_confidence);
+    w.gauge("confidence", "{stat=\"max\"}", m.max_confidence);
+    w.gauge("confidence", "{stat=\"stddev\"}", m.stddev_confidence);
+    const FallbackRegimes& r = m.fallback_regimes;
+    w.header("fallback_episodes", "counter", "Fallback streaks started.");
+    w.counter("fallback_episodes", "", r.fallback_episodes);
+    w.header("regime_time_seconds", "counter", "Time spent in each regime.");
+    w.gauge("regime_time_seconds_total", "{regime=\"fallback\"}", r.time_in_fallback_ns / 1e9);
+    w.gauge("regime_time_seconds_total", "{regime=\"normal\"}", r.time_in_normal_ns / 1e9);
+    w.header("fallback_streak", "gauge", "Consecutive decisions in the current regime.");
+    w.gauge("fallback_streak", r.in_fallback ? "{regime=\"fallback\"}" : "{regime=\"normal\"}",
+            static_cast<double>(r.current_streak));
+    w.header("fallback_streak_longest", "gauge", "Longest streak per regime.");
+    w.gauge("fallback_streak_longest", "{regime=\"fallback\"}",
+            static_cast<double>(r.longest_fallback_streak));
+    w.gauge("fallback_streak_longest", "{regime=\"normal\"}",
+            static_cast<double>(r.longest_normal_streak));
+    w.header("last_decision_timestamp_seconds", "gauge", "Timestamp of the last decision.");
+    w.gauge("last_decision_timestamp_seconds", "", m.last_decision_timestamp_ns / 1e9);
+    w.header("counter_overflow", "gauge", "1 if a counter overflow was detected.");
+    w.gauge("counter_overflow", "", m.overflow_detected ? 1.0 : 0.0);
+
+    if (m.confidence_percentiles.count > 0) {
+        w.summary("confidence_distribution", "Decision confidence.", m.confidence_percentiles);
+        w.summary("final_value", "Decision final_value.", m.final_value_percentiles);
+    }
+    if (m.latency_ns_percentiles.count > 0) {
+        w.summary("decision_latency_seconds", "makeDecision latency.",
+                  m.latency_ns_percentiles, 1e-9);
+    }
+    bool by_status = false;
+    for (const PercentileSummary& p : m.latency_ns_by_status) by_status |= p.count > 0;
+    if (by_status) {
+        w.header("decision_latency_by_status_seconds", "summary",
+                 "makeDecision latency by outcome status.");
+        for (int i = 0; i < DECISION_STATUS_COUNT; ++i) {
+            const PercentileSummary& p = m.latency_ns_by_status[i];
+            if (p.count == 0) continue;
+            std::snprintf(labels, sizeof(labels), "status=\"%s\"",
+                          decisionStatusLabel(static_cast<DecisionStatus>(i)));
+            w.summarySamples("decision_latency_by_status_seconds", labels, p, 1e-9);
+        }
+    }
+
+    w.finish();
+}
+
+// ============================================================================
+// HTTP EXPORTER
+// ============================================================================
+
+struct PrometheusExporterConfig {
+    std::string bind_address;          // Default: 127.0.0.1 (localhost only)
+    uint16_t port;                     // Default: 9464 (0 = ephemeral)
+    std::string metric_prefix;         // Default: "aille"
+    size_t initial_buffer_bytes;       // Default: 16 KB
+
+    PrometheusExporterConfig()
+        : bind_address("127.0.0.1"),
+          port(9464),
+          metric_prefix("aille"),
+          initial_buffer_bytes(16384) {}
+};
+
+class PrometheusExporter {
+private:
+    const MetricsCollector& collector;
+    PrometheusExporterConfig config;
+    MetricsCollector::Scratch scratch;
+    std::string body;
+    std::string response;
+
+    std::thread server_thread;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> scrape_count{0};
+    int listen_fd = -1;
+    uint16_t bound_port = 0;
+
+public:
+    explicit PrometheusExporter(const MetricsCollector& c,
+                                const PrometheusExporterConfig& cfg = PrometheusExporterConfig())
+        : collector(c), config(cfg), scratch(c.makeScratch()) {
+        body.reserve(config.initial_buffer_bytes);
+        response.reserve(config.initial_buffer_bytes + 256);
+    }
+
+    ~PrometheusExporter() { stop(); }
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    // Binds and starts the server thread; false if the socket cannot be
+    // opened (port in use, unsupported platform)
+    bool start() {
+#ifdef AILLE_HAS_POSIX_SOCKETS
+        if (running.load()) return true;
+
+        listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) return false;
+
+        int yes = 1;
+        ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (::inet_pton(AF_INET, config.bind_address.c_str(), &addr.sin_addr) != 1 ||
+            ::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listen_fd, 16) != 0) {
+            ::close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        bound_port = ntohs(addr.sin_port);
+
+        running.store(true);
+        server_thread = std::thread([this]() { serve(); });
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (server_thread.joinable()) server_thread.join();
+#ifdef AILLE_HAS_POSIX_SOCKETS
+        if (listen_fd >= 0) ::close(listen_fd);
+#endif
+        listen_fd = -1;
+    }
+
+    bool isRunning() const { return running.load(); }
+    uint16_t getPort() const { return bound_port; }
+    uint64_t getScrapeCount() const { return scrape_count.load(); }
+
+private:
+    // Server thread only: scratch and body are reused across scrapes
+    // without a lock. Other callers use formatPrometheus() on a snapshot.
+    void render(bool openmetrics) {
+        MetricsSnapshot snap = collector.getSnapshot(scratch);
+        body.clear();
+        formatPrometheus(snap, body, openmetrics, config.metric_prefix.c_str());
+    }
+
+#ifdef AILLE_HAS_POSIX_SOCKETS
+    void serve() {
+        while (running.load()) {
+            pollfd pfd;
+            pfd.fd = listen_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, 100) <= 0) continue;  // wake to check stop()
+
+            int client = ::accept(listen_fd, nullptr, nullptr);
+            if (client < 0) continue;
+            handle(client);
+            ::close(client);
+        }
+    }
+
+    void handle(int client) {
+        char request[4096];
+        size_t used = 0;
+
+        // Read until the end of the request headers (bounded, 1 s timeout)
+        while (used < sizeof(request) - 1) {
+            pollfd pfd;
+            pfd.fd = client;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (::poll(&pfd, 1, 1000) <= 0) return;
+            ssize_t n = ::recv(client, request + used, sizeof(request) - 1 - used, 0);
+            if (n <= 0) return;
+            used += static_cast<size_t>(n);
+            request[used] = '\0';
+            if (std::strstr(request, "\r\n\r\n") != nullptr) break;
+        }
+        request[used] = '\0';
+
+        if (std::strncmp(request, "GET ", 4) != 0) {
+            respond(client, "405 Method Not Allowed", "text/plain", "method not allowed\n");
+            return;
+        }
+        const char* path = request + 4;
+        if (std::strncmp(path, "/metrics ", 9) != 0 && std::strncmp(path, "/metrics?", 9) != 0) {
+            respond(client, "404 Not Found", "text/plain", "try /metrics\n");
+            return;
+        }
+
+        bool openmetrics = std::strstr(request, "application/openmetrics-text") != nullptr;
+        render(openmetrics);
+        respond(client, "200 OK",
+                openmetrics ? "application/openmetrics-text; version=1.0.0; charset=utf-8"
+                            : "text/plain; version=0.0.4; charset=utf-8",
+                body.c_str());
+        scrape_count.fetch_add(1);
+    }
+
+    void respond(int client, const char* status, const char* content_type,
+                 const char* payload) {
+        size_t payload_len = std::strlen(payload);
+        response.assign("HTTP/1.1 ");
+        response.append(status);
+        response.append("\r\nContent-Type: ");
+        response.append(content_type);
+        response.append("\r\nContent-Length: ");
+        response.append(std::to_string(payload_len));
+        response.append("\r\nConnection: close\r\n\r\n");
+        response.append(payload, payload_len);
+
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t w = ::send(client, response.data() + sent, response.size() - sent,
+                               MSG_NOSIGNAL);
+            if (w <= 0) return;
+            sent += static_cast<size_t>(w);
+        }
+    }
+#else
+    void serve() {}
+#endif
+};
+
+} // namespace AILLE
+
+#endif // AILLE_PROMETHEUS_HPP
@@ -0,0 +1,237 @@
+/*
+ * AILLE Metrics Extension - Streaming Quantile Sketch
+ * KLL sketch: bounded memory, mergeable, provable rank error
+ *
+ * License: MIT (see LICENSE)
+ *
+ * Karnin, Lang & Liberty, "Optimal Quantile Approximation in Streams"
+ * (FOCS 2016). Items enter level 0; when the sketch exceeds its capacity
+ * a full level is sorted and every other item (random offset) is promoted
+ * to the next level with doubled weight. Level capacities shrink
+ * geometrically (factor 2/3) below the top level, so total memory is about
+ * 3k items regardless of stream length, and the normalized rank error is
+ * roughly 1.33% at k = 200 (see getNormalizedRankError()).
+ *
+ * Not internally synchronized; owners (e.g. MetricsCollector) lock.
+ */
+
+#ifndef AILLE_QUANTILE_SKETCH_HPP
+#define AILLE_QUANTILE_SKETCH_HPP
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace AILLE {
+
+// ============================================================================
+// KLL QUANTILE SKETCH
+// ============================================================================
+
+class KllSketch {
+public:
+    static constexpr int DEFAULT_K = 200;
+    static constexpr int MIN_LEVEL_CAPACITY = 8;
+
+private:
+    int k;
+    uint64_t n = 0;                          // items seen
+    size_t retained = 0;                     // items currently stored
+    size_t max_retained = 0;                 // sum of level capacities
+    std::vector<std::vector<float>> levels;  // level h items have weight 2^h
+    uint64_t rng_state;
+    float min_value = 0.0f;
+    float max_value = 0.0f;
+
+public:
+    explicit KllSketch(int k_ = DEFAULT_K, uint64_t seed = 0x9e3779b97f4a7c15ULL)
+        : k(std::max(k_, MIN_LEVEL_CAPACITY)), rng_state(seed ? seed : 1) {
+        addLevel();
+    }
+
+    // Amortized O(log k): occasional sort of one level
+    void update(float value) {
+        if (std::isnan(value)) return;
+        if (n == 0) {
+            min_value = value;
+            max_value = value;
+        } else {
+            min_value = std::min(min_value, value);
+            max_value = std::max(max_value, value);
+        }
+        levels[0].push_back(value);
+        ++n;
+        ++retained;
+        if (retained >= max_retained) compress();
+    }
+
+    // Merging two sketches yields a sketch of the combined stream with the
+    // same error guarantee (k of this sketch applies)
+    void merge(const KllSketch& other) {
+        if (other.n == 0) return;
+        if (n == 0) {
+            min_value = other.min_value;
+            max_value = other.max_value;
+        } else {
+            min_value = std::min(min_value, other.min_value);
+            max_value = std::max(max_value, other.max_value);
+        }
+
+        while (levels.size() < other.levels.size()) addLevel();
+        for (size_t h = 0; h < other.levels.size(); ++h) {
+            levels[h].insert(levels[h].end(),
+                             other.levels[h].begin(), other.levels[h].end());
+        }
+        n += other.n;
+        retained += other.retained;
+        while (retained >= max_retained) compress();
+    }
+
+    // Approximate value at normalized rank q in [0, 1]
+    float quantile(double q) const {
+        if (n == 0) return 0.0f;
+        if (q <= 0.0) return min_value;
+        if (q >= 1.0) return max_value;
+
+        std::vector<std::pair<float, uint64_t>> weighted = weightedItems();
+        uint64_t total = 0;
+        for (const auto& w : weighted) total += w.second;
+
+        double target = q * static_cast<double>(total);
+        uint64_t cumulative = 0;
+        for (const auto& w : weighted) {
+            cumulative += w.second;
+            if (static_cast<double>(cumulative) >= target) return w.first;
+        }
+        return max_value;
+    }
+
+    // Approximate fraction of items <= value
+    double rank(float value) const {
+        if (n == 0) return 0.0;
+        uint64_t below = 0;
+        uint64_t total = 0;
+        for (size_t h = 0; h < levels.size(); ++h) {
+            uint64_t w = uint64_t(1) << h;
+            for (float v : levels[h]) {
+                total += w;
+                if (v <= value) below += w;
+            }
+        }
+        return static_cast<double>(below) / static_cast<double>(total);
+    }
+
+    void reset() {
+        levels.clear();
+        n = 0;
+        retained = 0;
+        max_retained = 0;
+        min_value = 0.0f;
+        max_value = 0.0f;
+        addLevel();
+    }
+
+    uint64_t getN() const { return n; }
+    size_t getRetainedItems() const { return retained; }
+    float getMin() const { return min_value; }
+    float getMax() const { return max_value; }
+    int getK() const { return k; }
+    size_t getMemoryBytes() const {
+        size_t bytes = sizeof(*this);
+        for (const auto& level : levels) bytes += level.capacity() * sizeof(float);
+        return bytes;
+    }
+
+    // Single-sided normalized rank error (~99% confidence), empirical
+    // constants from the Apache DataSketches KLL implementation
+    static double getNormalizedRankError(int k_) {
+        return 2.296 / std::pow(static_cast<double>(k_), 0.9723);
+    }
+    double getNormalizedRankError() const { return getNormalizedRankError(k); }
+
+    // Raw level access, e.g. for checkpointing
+    const std::vector<std::vector<float>>& getLevels() const { return levels; }
+
+    void restore(uint64_t n_, float min_, float max_,
+                 const std::vector<std::vector<float>>& levels_) {
+        reset();
+        while (levels.size() < levels_.size()) addLevel();
+        retained = 0;
+        for (size_t h = 0; h < levels_.size(); ++h) {
+            levels[h] = levels_[h];
+            retained += levels_[h].size();
+        }
+        n = n_;
+        min_value = min_;
+        max_value = max_;
+        while (retained >= max_retained) compress();
+    }
+
+private:
+    size_t levelCapacity(size_t h) const {
+        size_t depth = levels.size() - 1 - h;
+        double cap = std::ceil(k * std::pow(2.0 / 3.0, static_cast<double>(depth)));
+        return std::max<size_t>(MIN_LEVEL_CAPACITY, static_cast<size_t>(cap));
+    }
+
+    void addLevel() {
+        levels.emplace_back();
+        max_retained = 0;
+        for (size_t h = 0; h < levels.size(); ++h) max_retained += levelCapacity(h);
+    }
+
+    bool randomBit() {
+        // xorshift64
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 7;
+        rng_state ^= rng_state << 17;
+        return (rng_state & 1) != 0;
+    }
+
+    // Compact the lowest over-capacity level(s) until back under budget
+    void compress() {
+        for (size_t h = 0; h < levels.size(); ++h) {
+            if (levels[h].size() < levelCapacity(h)) continue;
+            if (h + 1 == levels.size()) addLevel();
+
+            std::vector<float>& level = levels[h];
+            std::vector<float>& next = levels[h + 1];
+            std::sort(level.begin(), level.end());
+
+            // Keep one item behind if the level is odd-sized
+            size_t pairs = level.size() / 2;
+            size_t start = level.size() - 2 * pairs;
+            size_t offset = randomBit() ? 1 : 0;
+            for (size_t i = 0; i < pairs; ++i) {
+                next.push_back(level[start + 2 * i + offset]);
+            }
+            level.resize(start);
+            retained -= pairs;
+
+            // Levels shrink as the sketch deepens; release slack so memory
+            // stays proportional to the current capacities
+            if (level.capacity() > 2 * levelCapacity(h)) level.shrink_to_fit();
+
+            if (retained < max_retained) break;
+        }
+    }
+
+    std::vector<std::pair<float, uint64_t>> weightedItems() const {
+        std::vector<std::pair<float, uint64_t>> out;
+        out.reserve(retained);
+        for (size_t h = 0; h < levels.size(); ++h) {
+            uint64_t w = uint64_t(1) << h;
+            for (float v : levels[h]) out.emplace_back(v, w);
+        }
+        std::sort(out.begin(), out.end(),
+                  [](const std::pair<float, uint64_t>& a,
+                     const std::pair<float, uint64_t>& b) { return a.first < b.first; });
+        return out;
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_QUANTILE_SKETCH_HPP
@@ -0,0 +1,426 @@
+/*
+ * AILLE Metrics Extension - Shared-Memory Export
+ * Out-of-process metric reads with zero IPC into the decision process
+ *
+ * License: MIT (see LICENSE)
+ *
+ * A publisher thread mirrors the collector's published snapshot
+ * (publishSnapshot() / startPublishing()) into a POSIX shared-memory page;
+ * dashboards and watchdogs map the page read-only and poll it (see
+ * tools/aille_top.cpp). The publisher never takes the collector lock and
+ * nothing in the decision process ever waits on a reader.
+ *
+ *   - the payload is guarded by a seqlock: the writer bumps the sequence to
+ *     odd, writes, bumps to even; readers retry if the sequence was odd or
+ *     changed while they copied
+ *   - the layout is fixed-width, versioned (SHM_LAYOUT_VERSION) and
+ *     self-describing (magic, header and payload sizes), independent of
+ *     the in-process MetricsSnapshot layout
+ *
+ * POSIX only; open() returns false on other platforms.
+ */
+
+#ifndef AILLE_SHM_METRICS_HPP
+#define AILLE_SHM_METRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define AILLE_HAS_POSIX_SHM 1
+#endif
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// PAGE LAYOUT (VERSIONED, FIXED-WIDTH)
+// ============================================================================
+
+static constexpr uint32_t SHM_MAGIC = 0x4d4c4941u;   // "AILM" little-endian
+static constexpr uint32_t SHM_LAYOUT_VERSION = 2;
+static constexpr int SHM_MODELS_BUCKETS = 64;        // independent of MAX_MODELS
+static constexpr int SHM_STATUS_SLOTS = 8;           // DecisionStatus values, zero-padded
+static constexpr int SHM_STREAK_BUCKETS = 32;        // independent of FallbackRegimes
+
+static_assert(DECISION_STATUS_COUNT <= SHM_STATUS_SLOTS,
+              "DecisionStatus outgrew the shared-memory layout; bump SHM_LAYOUT_VERSION");
+
+struct ShmPercentiles {
+    uint64_t count;
+    double sum;
+    float p50;
+    float p90;
+    float p99;
+    float p999;
+};
+
+struct ShmFallbackRegimes {
+    uint32_t in_fallback;
+    uint32_t reserved0;
+    uint64_t current_streak;
+    uint64_t current_streak_ns;
+    uint64_t longest_fallback_streak;
+    uint64_t longest_normal_streak;
+    uint64_t fallback_episodes;
+    uint64_t time_in_fallback_ns;
+    uint64_t time_in_normal_ns;
+    uint64_t fallback_streak_log2[SHM_STREAK_BUCKETS];  // bucket i: lengths [2^i, 2^(i+1))
+    uint64_t normal_streak_log2[SHM_STREAK_BUCKETS];
+};
+
+struct ShmMetricsPayload {
+    uint64_t publish_count;
+    uint64_t publish_timestamp_ns;          // steady clock, system-wide on Linux
+    uint64_t snapshot_generation;           // collector's published generation (0 = none yet)
+
+    uint64_t total_decisions;
+    uint64_t valid_decisions;
+    uint64_t fallback_activations;
+    uint64_t rejected_confidence;
+    uint64_t rejected_consensus;
+    uint64_t invalid_inputs;
+    uint64_t last_decision_timestamp_ns;
+
+    float average_confidence;
+    float fallback_rate;
+    float consensus_failure_rate;
+    float min_confidence;
+    float max_confidence;
+    float stddev_confidence;
+    uint32_t overflow_detected;
+    uint32_t reserved0;
+
+    uint64_t models_agreed[SHM_MODELS_BUCKETS + 1];
+    uint64_t models_agreed_overflow;
+
+    ShmPercentiles confidence;
+    ShmPercentiles final_value;
+    ShmPercentiles latency_ns;
+    ShmPercentiles latency_ns_by_status[SHM_STATUS_SLOTS];  // indexed by DecisionStatus
+
+    ShmFallbackRegimes fallback_regimes;
+};
+
+struct alignas(64) ShmMetricsPage {
+    // Written once at creation, before readers can validate the magic
+    uint32_t magic;
+    uint32_t layout_version;
+    uint32_t header_size;
+    uint32_t payload_size;
+    uint64_t writer_pid;
+
+    alignas(64) std::atomic<uint64_t> sequence;  // odd while a write is in progress
+    alignas(64) ShmMetricsPayload payload;
+};
+
+static_assert(std::is_trivially_copyable<ShmMetricsPayload>::value,
+              "ShmMetricsPayload is copied with memcpy");
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "seqlock sequence must be lock-free to be shared across processes");
+
+inline void toShmPayload(const MetricsSnapshot& s, ShmMetricsPayload& p) {
+    p.total_decisions = s.total_decisions;
+    p.valid_decisions = s.valid_decisions;
+    p.fallback_activations = s.fallback_activations;
+    p.rejected_confidence = s.rejected_confidence;
+    p.rejected_consensus = s.rejected_consensus;
+    p.invalid_inputs = s.invalid_inputs;
+    p.last_decision_timestamp_ns = s.last_decision_timestamp_ns;
+    p.average_confidence = s.average_confidence;
+    p.fallback_rate = s.fallback_rate;
+    p.consensus_failure_rate = s.consensus_failure_rate;
+    p.min_confidence = s.min_confidence;
+    p.max_confidence = s.max_confidence;
+    p.stddev_confidence = s.stddev_confidence;
+    p.overflow_detected = s.overflow_detected ? 1u : 0u;
+    p.reserved0 = 0;
+
+    std::memset(p.models_agreed, 0, sizeof(p.models_agreed));
+    p.models_agreed_overflow = s.models_agreed_histogram.overflow;
+    for (int n = 0; n <= ModelsAgreedHistogram::MAX_MODELS; ++n) {
+        if (n <= SHM_MODELS_BUCKETS) {
+            p.models_agreed[n] = s.models_agreed_histogram.buckets[n];
+        } else {
+            p.models_agreed_overflow += s.models_agreed_histogram.buckets[n];
+        }
+    }
+
+    auto copy = [](const PercentileSummary& in, ShmPercentiles& out) {
+        out.count = in.count;
+        out.sum = in.sum;
+        out.p50 = in.p50;
+        out.p90 = in.p90;
+        out.p99 = in.p99;
+        out.p999 = in.p999;
+    };
+    copy(s.confidence_percentiles, p.confidence);
+    copy(s.final_value_percentiles, p.final_value);
+    copy(s.latency_ns_percentiles, p.latency_ns);
+    std::memset(p.latency_ns_by_status, 0, sizeof(p.latency_ns_by_status));
+    for (int i = 0; i < DECISION_STATUS_COUNT; ++i) {
+        copy(s.latency_ns_by_status[i], p.latency_ns_by_status[i]);
+    }
+
+    const FallbackRegimes& r = s.fallback_regimes;
+    ShmFallbackRegimes& out = p.fallback_regimes;
+    std::memset(&out, 0, sizeof(out));
+    out.in_fallback = r.in_fallback ? 1u : 0u;
+    out.current_streak = r.current_streak;
+    out.current_streak_ns = r.current_streak_ns;
+    out.longest_fallback_streak = r.longest_fallback_streak;
+    out.longest_normal_streak = r.longest_normal_streak;
+    out.fallback_episodes = r.fallback_episodes;
+    out.time_in_fallback_ns = r.time_in_fallback_ns;
+    out.time_in_normal_ns = r.time_in_normal_ns;
+    // Longer streaks than the page can bucket land in its last bucket
+    for (int b = 0; b < FallbackRegimes::STREAK_BUCKETS; ++b) {
+        int to = std::min(b, SHM_STREAK_BUCKETS - 1);
+        out.fallback_streak_log2[to] += r.fallback_streak_log2[b];
+        out.normal_streak_log2[to] += r.normal_streak_log2[b];
+    }
+}
+
+inline uint64_t shmSteadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// PUBLISHER (SINGLE WRITER, IN THE DECISION PROCESS)
+// ============================================================================
+
+// The page mirrors the collector's published snapshot, so the collector
+// must publish (metrics.startPublishing(...) or publishSnapshot()); the
+// page then refreshes at that cadence. Between new snapshots each interval
+// only advances the heartbeat (publish_count, publish_timestamp_ns).
+struct ShmMetricsConfig {
+    std::string name;                      // Default: "/aille_metrics"
+    std::chrono::microseconds interval;    // Default: 500 us (heartbeat)
+    bool unlink_on_close;                  // Default: true
+
+    ShmMetricsConfig()
+        : name("/aille_metrics"),
+          interval(500),
+          unlink_on_close(true) {}
+};
+
+class ShmMetricsPublisher {
+private:
+    const MetricsCollector& collector;
+    ShmMetricsConfig config;
+    MetricsSnapshot snapshot;
+    ShmMetricsPayload staging;
+    uint64_t snapshot_generation = 0;
+
+    std::mutex write_mtx;                  // serializes publish() with the thread
+    ShmMetricsPage* page = nullptr;
+    uint64_t publish_count = 0;
+
+    std::thread publisher_thread;
+    std::atomic<bool> running{false};
+
+public:
+    explicit ShmMetricsPublisher(const MetricsCollector& c,
+                                 const ShmMetricsConfig& cfg = ShmMetricsConfig())
+        : collector(c), config(cfg), snapshot(), staging() {}
+
+    ~ShmMetricsPublisher() { close(); }
+
+    ShmMetricsPublisher(const ShmMetricsPublisher&) = delete;
+    ShmMetricsPublisher& operator=(const ShmMetricsPublisher&) = delete;
+
+    // Creates (or takes over) the shared-memory object
+    bool open() {
+#ifdef AILLE_HAS_POSIX_SHM
+        if (page) return true;
+        int fd = ::shm_open(config.name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        if (::ftruncate(fd, sizeof(ShmMetricsPage)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mem = ::mmap(nullptr, sizeof(ShmMetricsPage), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) return false;
+
+        // Invalidate the magic first so readers ignore a half-initialized page
+        page = static_cast<ShmMetricsPage*>(mem);
+        page->magic = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        new (&page->sequence) std::atomic<uint64_t>(0);
+        std::memset(&page->payload, 0, sizeof(page->payload));
+        page->layout_version = SHM_LAYOUT_VERSION;
+        page->header_size = static_cast<uint32_t>(offsetof(ShmMetricsPage, payload));
+        page->payload_size = static_cast<uint32_t>(sizeof(ShmMetricsPayload));
+        page->writer_pid = static_cast<uint64_t>(::getpid());
+        std::atomic_thread_fence(std::memory_order_release);
+        page->magic = SHM_MAGIC;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Opens if needed and publishes every config.interval
+    bool start() {
+        if (!open()) return false;
+        if (running.exchange(true)) return true;
+        publisher_thread = std::thread([this]() {
+            while (running.load(std::memory_order_relaxed)) {
+                publish();
+                std::this_thread::sleep_for(config.interval);
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        if (publisher_thread.joinable()) publisher_thread.join();
+    }
+
+    void close() {
+        stop();
+#ifdef AILLE_HAS_POSIX_SHM
+        if (page) {
+            ::munmap(page, sizeof(ShmMetricsPage));
+            if (config.unlink_on_close) ::shm_unlink(config.name.c_str());
+        }
+#endif
+        page = nullptr;
+    }
+
+    // One seqlock write. The payload is rebuilt only when the collector
+    // has published a new snapshot; the collector lock is never taken.
+    void publish() {
+        std::lock_guard<std::mutex> lock(write_mtx);
+        if (!page) return;
+
+        if (collector.getPublishedGeneration() != snapshot_generation) {
+            snapshot_generation = collector.getPublishedSnapshot(snapshot);
+            toShmPayload(snapshot, staging);
+            staging.snapshot_generation = snapshot_generation;
+        }
+        staging.publish_count = ++publish_count;
+        staging.publish_timestamp_ns = shmSteadyNowNs();
+
+        uint64_t seq = page->sequence.load(std::memory_order_relaxed);
+        page->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&page->payload, &staging, sizeof(staging));
+        page->sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    bool isOpen() const { return page != nullptr; }
+    bool isRunning() const { return running.load(); }
+    const std::string& getName() const { return config.name; }
+};
+
+// ============================================================================
+// READER (ANY PROCESS)
+// ============================================================================
+
+enum ShmReadStatus {
+    SHM_READ_OK,
+    SHM_READ_NOT_OPEN,
+    SHM_READ_BAD_LAYOUT,     // magic/version/size mismatch
+    SHM_READ_CONTENDED       // writer kept the page busy for every retry
+};
+
+class ShmMetricsReader {
+private:
+    const ShmMetricsPage* page = nullptr;
+    std::string name;
+
+public:
+    ShmMetricsReader() = default;
+    ~ShmMetricsReader() { close(); }
+
+    ShmMetricsReader(const ShmMetricsReader&) = delete;
+    ShmMetricsReader& operator=(const ShmMetricsReader&) = delete;
+
+    bool open(const std::string& shm_name = ShmMetricsConfig().name) {
+#ifdef AILLE_HAS_POSIX_SHM
+        close();
+        int fd = ::shm_open(shm_name.c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 ||
+            static_cast<size_t>(st.st_size) < sizeof(ShmMetricsPage)) {
+            ::close(fd);
+            return false;
+        }
+        void* mem = ::mmap(nullptr, sizeof(ShmMetricsPage), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mem == MAP_FAILED) return false;
+        page = static_cast<const ShmMetricsPage*>(mem);
+        name = shm_name;
+        return true;
+#else
+        (void)shm_name;
+        return false;
+#endif
+    }
+
+    void close() {
+#ifdef AILLE_HAS_POSIX_SHM
+        if (page) ::munmap(const_cast<ShmMetricsPage*>(page), sizeof(ShmMetricsPage));
+#endif
+        page = nullptr;
+    }
+
+    bool isOpen() const { return page != nullptr; }
+
+    bool isCompatible() const {
+        return page && page->magic == SHM_MAGIC &&
+               page->layout_version == SHM_LAYOUT_VERSION &&
+               page->header_size == offsetof(ShmMetricsPage, payload) &&
+               page->payload_size == sizeof(ShmMetricsPayload);
+    }
+
+    uint64_t getWriterPid() const { return page ? page->writer_pid : 0; }
+
+    // Consistent copy of the payload; never blocks the writer
+    ShmReadStatus read(ShmMetricsPayload& out, int max_retries = 1000) const {
+        if (!page) return SHM_READ_NOT_OPEN;
+        if (!isCompatible()) return SHM_READ_BAD_LAYOUT;
+
+        for (int attempt = 0; attempt < max_retries; ++attempt) {
+            uint64_t before = page->sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            std::memcpy(&out, &page->payload, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = page->sequence.load(std::memory_order_relaxed);
+            if (before == after) return SHM_READ_OK;
+        }
+        return SHM_READ_CONTENDED;
+    }
+
+    // True if the writer has not published within max_age
+    static bool isStale(const ShmMetricsPayload& p, std::chrono::nanoseconds max_age) {
+        uint64_t now = shmSteadyNowNs();
+        return p.publish_count == 0 ||
+               now - p.publish_timestamp_ns > static_cast<uint64_t>(max_age.count());
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_SHM_METRICS_HPP
@@ -0,0 +1,323 @@
+/*
+ * AILLE Metrics Extension - StatsD / DogStatsD Exporter
+ * Batched UDP push to a local StatsD agent
+ *
+ * License: MIT (see LICENSE)
+ *
+ * A background thread diffs each MetricsCollector snapshot against the
+ * previous one and pushes:
+ *
+ *   - counter deltas        aille.decisions:412|c
+ *   - gauges                aille.fallback_rate:0.031|g
+ *   - distribution summary  aille.latency_ns.p99:8123|g
+ *
+ * Lines are packed into datagrams of at most max_datagram_bytes (default
+ * sized for a 1500-byte MTU). Buffers are allocated once at construction;
+ * sends use MSG_DONTWAIT, so a stalled agent drops datagrams instead of
+ * blocking. Decision threads are never touched: snapshots hold the
+ * collector lock only for a memcpy, or not at all with
+ * use_published_snapshots.
+ *
+ * POSIX sockets only; start() returns false on other platforms.
+ */
+
+#ifndef AILLE_STATSD_HPP
+#define AILLE_STATSD_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#define AILLE_HAS_POSIX_SOCKETS 1
+#endif
+
+#include "aille.hpp"
+#include "aille_metrics.hpp"
+
+namespace AILLE {
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+struct StatsdExporterConfig {
+    std::string host;                      // Default: 127.0.0.1
+    uint16_t port;                         // Default: 8125
+    std::string prefix;                    // Default: "aille."
+    std::chrono::milliseconds interval;    // Default: 1000 ms
+    size_t max_datagram_bytes;             // Default: 1432 (1500 MTU - headers)
+    bool dogstatsd_tags;                   // Default: false (plain StatsD names)
+    std::string constant_tags;             // Default: "" (DogStatsD only, e.g. "env:prod")
+    bool use_published_snapshots;          // Default: false (see publishSnapshot())
+
+    StatsdExporterConfig()
+        : host("127.0.0.1"),
+          port(8125),
+          prefix("aille."),
+          interval(1000),
+          max_datagram_bytes(1432),
+          dogstatsd_tags(false),
+          constant_tags(),
+          use_published_snapshots(false) {}
+};
+
+// ============================================================================
+// STATSD EXPORTER
+// ============================================================================
+
+class StatsdExporter {
+private:
+    const MetricsCollector& collector;
+    StatsdExporterConfig config;
+    MetricsCollector::Scratch scratch;
+
+    MetricsSnapshot previous;
+    bool have_previous = false;
+
+    std::vector<char> datagram;            // fixed capacity, never grows
+    size_t datagram_used = 0;
+    std::string line_buf;                  // grows only for an unusually long line
+    int sock = -1;
+
+    std::thread exporter_thread;
+    std::mutex state_mtx;
+    std::condition_variable state_cv;
+    bool running = false;                  // protected by state_mtx
+    std::mutex flush_mtx;                  // serializes flush() callers
+
+    std::atomic<uint64_t> flushes{0};
+    std::atomic<uint64_t> datagrams_sent{0};
+    std::atomic<uint64_t> send_errors{0};
+    std::atomic<uint64_t> lines_dropped{0};
+
+public:
+    explicit StatsdExporter(const MetricsCollector& c,
+                            const StatsdExporterConfig& cfg = StatsdExporterConfig())
+        : collector(c), config(cfg), scratch(c.makeScratch()),
+          datagram(std::max<size_t>(cfg.max_datagram_bytes, 256)) {
+        line_buf.resize(LINE_RESERVE);
+    }
+
+    ~StatsdExporter() {
+        stop();
+        closeSocket();
+    }
+
+    StatsdExporter(const StatsdExporter&) = delete;
+    StatsdExporter& operator=(const StatsdExporter&) = delete;
+
+    // Opens the UDP socket and starts the flush thread
+    bool start() {
+        if (!openSocket()) return false;
+        std::lock_guard<std::mutex> lock(state_mtx);
+        if (running) return true;
+        running = true;
+        exporter_thread = std::thread([this]() {
+            std::unique_lock<std::mutex> state(state_mtx);
+            while (running) {
+                state_cv.wait_for(state, config.interval, [this]() { return !running; });
+                if (!running) break;
+                state.unlock();
+                flush();
+                state.lock();
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(state_mtx);
+            if (!running) return;
+            running = false;
+        }
+        state_cv.notify_all();
+        if (exporter_thread.joinable()) exporter_thread.join();
+    }
+
+    // Diffs the current snapshot against the last one and sends it. The
+    // first flush sends full counter values as deltas.
+    void flush() {
+        std::lock_guard<std::mutex> lock(flush_mtx);
+        if (sock < 0 && !openSocket()) return;
+
+        MetricsSnapshot current;
+        if (config.use_published_snapshots) {
+            if (collector.getPublishedSnapshot(current) == 0) return;
+        } else {
+            current = collector.getSnapshot(scratch);
+        }
+
+        datagram_used = 0;
+        counter("decisions", delta(current.total_decisions, previous.total_decisions));
+        counter("decisions_valid", delta(current.valid_decisions, previous.valid_decisions));
+        counter("fallback_activations",
+                delta(current.fallback_activations, previous.fallback_activations));
+        counter("rejected.confidence",
+                delta(current.rejected_confidence, previous.rejected_confidence));
+        counter("rejected.consensus",
+                delta(current.rejected_consensus, previous.rejected_consensus));
+        counter("invalid_inputs", delta(current.invalid_inputs, previous.invalid_inputs));
+
+        char name[48];
+        for (int n = 0; n <= ModelsAgreedHistogram::MAX_MODELS; ++n) {
+            uint64_t d = delta(current.models_agreed_histogram.buckets[n],
+                               previous.models_agreed_histogram.buckets[n]);
+            if (d == 0) continue;
+            if (config.dogstatsd_tags) {
+                std::snprintf(name, sizeof(name), "models:%d", n);
+                line("models_agreed", static_cast<double>(d), "c", name);
+            } else {
+                std::snprintf(name, sizeof(name), "models_agreed.%d", n);
+                counter(name, d);
+            }
+        }
+
+        gauge("fallback_rate", current.fallback_rate);
+        gauge("consensus_failure_rate", current.consensus_failure_rate);
+        gauge("confidence.avg", current.average_confidence);
+        gauge("confidence.min", current.min_confidence);
+        gauge("confidence.max", current.max_confidence);
+        gauge("confidence.stddev", current.stddev_confidence);
+
+        counter("fallback_episodes", delta(current.fallback_regimes.fallback_episodes,
+                                           previous.fallback_regimes.fallback_episodes));
+        gauge("fallback_streak.current",
+              static_cast<double>(current.fallback_regimes.in_fallback
+                                      ? current.fallback_regimes.current_streak : 0));
+        gauge("fallback_streak.longest",
+              static_cast<double>(current.fallback_regimes.longest_fallback_streak));
+        gauge("fallback_time_fraction", current.fallback_regimes.fallbackTimeFraction());
+
+        summary("confidence", current.confidence_percentiles);
+        summary("final_value", current.final_value_percentiles);
+        summary("latency_ns", current.latency_ns_percentiles);
+
+        sendDatagram();
+        previous = current;
+        have_previous = true;
+        flushes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t getFlushCount() const { return flushes.load(std::memory_order_relaxed); }
+    uint64_t getDatagramsSent() const { return datagrams_sent.load(std::memory_order_relaxed); }
+    uint64_t getSendErrors() const { return send_errors.load(std::memory_order_relaxed); }
+
+    // Lines longer than a whole datagram (a long prefix, name or
+    // constant_tags); these are never sent
+    uint64_t getLinesDropped() const { return lines_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t LINE_RESERVE = 256;
+
+    // Counter deltas; a collector reset() shows up as a decrease
+    uint64_t delta(uint64_t now, uint64_t before) const {
+        if (!have_previous || now < before) return now;
+        return now - before;
+    }
+
+    void counter(const char* name, uint64_t value) {
+        if (value > 0) line(name, static_cast<double>(value), "c", nullptr);
+    }
+
+    void gauge(const char* name, double value) { line(name, value, "g", nullptr); }
+
+    void summary(const char* name, const PercentileSummary& p) {
+        if (p.count == 0) return;
+        char full[64];
+        const char* suffixes[] = {"p50", "p90", "p99", "p999"};
+        const float values[] = {p.p50, p.p90, p.p99, p.p999};
+        for (int i = 0; i < 4; ++i) {
+            std::snprintf(full, sizeof(full), "%s.%s", name, suffixes[i]);
+            gauge(full, values[i]);
+        }
+    }
+
+    // Formats one line into line_buf (grown and formatted again when it
+    // is too short) and appends it, flushing first if the datagram would
+    // exceed max_datagram_bytes
+    void line(const char* name, double value, const char* type, const char* tag) {
+        const bool tagged = config.dogstatsd_tags && (tag || !config.constant_tags.empty());
+        const bool both = tag && !config.constant_tags.empty();
+        int n = 0;
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            n = std::snprintf(&line_buf[0], line_buf.size(), "%s%s:%.9g|%s%s%s%s%s\n",
+                              config.prefix.c_str(), name, value, type,
+                              tagged ? "|#" : "",
+                              config.dogstatsd_tags ? config.constant_tags.c_str() : "",
+                              both ? "," : "",
+                              tag ? tag : "");
+            if (n < 0 || static_cast<size_t>(n) < line_buf.size()) break;
+            line_buf.resize(static_cast<size_t>(n) + 1);
+        }
+        if (n <= 0) return;
+
+        size_t len = static_cast<size_t>(n);
+        if (len > datagram.size()) {
+            lines_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (datagram_used + len > datagram.size()) sendDatagram();
+        std::memcpy(datagram.data() + datagram_used, line_buf.data(), len);
+        datagram_used += len;
+    }
+
+    void sendDatagram() {
+        if (datagram_used == 0) return;
+#ifdef AILLE_HAS_POSIX_SOCKETS
+        // Drop the trailing newline; StatsD separates lines, not terminates
+        ssize_t sent = ::send(sock, datagram.data(), datagram_used - 1, MSG_DONTWAIT);
+        if (sent < 0) {
+            send_errors.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            datagrams_sent.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+        datagram_used = 0;
+    }
+
+    bool openSocket() {
+#ifdef AILLE_HAS_POSIX_SOCKETS
+        if (sock >= 0) return true;
+        int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) return false;
+
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config.port);
+        if (::inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr) != 1 ||
+            ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            return false;
+        }
+        sock = fd;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void closeSocket() {
+#ifdef AILLE_HAS_POSIX_SOCKETS
+        if (sock >= 0) ::close(sock);
+#endif
+        sock = -1;
+    }
+};
+
+} // namespace AILLE
+
+#endif // AILLE_STATSD_HPP
@@ -0,0 +1,180 @@
+/*
+ * AILLE Drift Alerting Tests
+ *
+ * EWMA and CUSUM detectors on synthetic bucket streams: rarely alarming
+ * on a noisy stationary baseline, firing in the right direction soon
+ * after a shift, silent during warm-up, and rate-limited by the cooldown.
+ */
+
+#include <random>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_alerting.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::Alert;
+using AILLE::AlertingConfig;
+using AILLE::AlertingEngine;
+
+struct Stream {
+    std::mt19937 rng;
+    std::normal_distribution<double> noise;
+    explicit Stream(uint32_t seed, double sigma) : rng(seed), noise(0.0, sigma) {}
+
+    // Fallback rate around `fallback`, confidence around `confidence`
+    void feed(AlertingEngine& engine, int buckets, double fallback, double confidence) {
+        for (int i = 0; i < buckets; ++i) {
+            engine.observeBucket(fallback + noise(rng), 0.01, confidence + noise(rng));
+        }
+    }
+};
+
+// Collects delivered alerts; create it before feeding the engine
+class AlertLog {
+public:
+    explicit AlertLog(AlertingEngine& e) : engine(e) {
+        engine.addCallback([this](const Alert& a) { alerts.push_back(a); });
+    }
+
+    // Alerts raised since the previous drain()
+    std::vector<Alert> drain() {
+        alerts.clear();
+        engine.dispatchPending();
+        return alerts;
+    }
+
+private:
+    AlertingEngine& engine;
+    std::vector<Alert> alerts;
+};
+
+const Alert* first(const std::vector<Alert>& alerts, AILLE::AlertSignal signal,
+                   AILLE::AlertDetector detector) {
+    for (const Alert& a : alerts) {
+        if (a.signal == signal && a.detector == detector) return &a;
+    }
+    return nullptr;
+}
+
+AILLE_TEST(stationary_stream_stays_quiet) {
+    // With the default limits a stationary stream averages about one false
+    // alarm per 2000 buckets across all signals, detectors and directions
+    AlertingEngine engine;
+    Stream stream(41, 0.01);
+    stream.feed(engine, 2000, 0.05, 0.8);
+    CHECK(engine.getAlertsRaised() <= 3);
+
+    AILLE::DriftDetectorState st = engine.getDetectorState(AILLE::ALERT_FALLBACK_RATE);
+    CHECK_NEAR(st.baseline_mean, 0.05, 0.005);
+    CHECK_NEAR(st.sigma(0.0), 0.01, 0.003);
+}
+
+AILLE_TEST(step_shift_fires_both_detectors_rising) {
+    AlertingEngine engine;
+    AlertLog alert_log(engine);
+    Stream stream(42, 0.01);
+    stream.feed(engine, 300, 0.05, 0.8);
+    uint64_t shift_at = engine.getBucketIndex();
+    stream.feed(engine, 20, 0.10, 0.8);   // +5 sigma
+
+    std::vector<Alert> alerts = alert_log.drain();
+    const Alert* ewma = first(alerts, AILLE::ALERT_FALLBACK_RATE, AILLE::DETECTOR_EWMA);
+    const Alert* cusum = first(alerts, AILLE::ALERT_FALLBACK_RATE, AILLE::DETECTOR_CUSUM);
+    CHECK(ewma != nullptr);
+    CHECK(cusum != nullptr);
+    if (ewma && cusum) {
+        CHECK(ewma->direction == AILLE::ALERT_RISING);
+        CHECK(cusum->direction == AILLE::ALERT_RISING);
+        CHECK(ewma->bucket_index >= shift_at && ewma->bucket_index < shift_at + 5);
+        CHECK(cusum->bucket_index >= shift_at && cusum->bucket_index < shift_at + 5);
+        CHECK_NEAR(ewma->baseline, 0.05, 0.01);
+    }
+    // Only the shifted signal alerted
+    for (const Alert& a : alerts) CHECK(a.signal == AILLE::ALERT_FALLBACK_RATE);
+}
+
+AILLE_TEST(small_sustained_shift_is_caught_by_cusum) {
+    AlertingEngine engine;
+    AlertLog alert_log(engine);
+    Stream stream(43, 0.01);
+    stream.feed(engine, 300, 0.05, 0.8);
+    uint64_t shift_at = engine.getBucketIndex();
+    stream.feed(engine, 60, 0.05, 0.785);   // -1.5 sigma on confidence
+
+    std::vector<Alert> alerts = alert_log.drain();
+    const Alert* cusum = first(alerts, AILLE::ALERT_MEAN_CONFIDENCE, AILLE::DETECTOR_CUSUM);
+    CHECK(cusum != nullptr);
+    if (cusum) {
+        CHECK(cusum->direction == AILLE::ALERT_FALLING);
+        CHECK(cusum->bucket_index >= shift_at);
+        CHECK(cusum->statistic < 0.0);
+    }
+}
+
+AILLE_TEST(no_alerts_during_warmup) {
+    AlertingConfig cfg;
+    cfg.warmup_buckets = 50;
+    AlertingEngine engine(cfg);
+    Stream stream(44, 0.01);
+    stream.feed(engine, 25, 0.05, 0.8);
+    stream.feed(engine, 25, 0.50, 0.2);
+    CHECK(engine.getBucketIndex() == 50);
+    CHECK(engine.getAlertsRaised() == 0);
+}
+
+AILLE_TEST(cooldown_limits_repeats) {
+    AlertingConfig cfg;
+    cfg.cooldown_buckets = 1000;
+    AlertingEngine engine(cfg);
+    AlertLog alert_log(engine);
+    Stream stream(45, 0.01);
+    stream.feed(engine, 300, 0.05, 0.8);
+    stream.feed(engine, 200, 0.20, 0.8);
+
+    std::vector<Alert> alerts = alert_log.drain();
+    int ewma_rising = 0, cusum_rising = 0;
+    for (const Alert& a : alerts) {
+        if (a.signal != AILLE::ALERT_FALLBACK_RATE || a.direction != AILLE::ALERT_RISING) continue;
+        (a.detector == AILLE::DETECTOR_EWMA ? ewma_rising : cusum_rising)++;
+    }
+    CHECK(ewma_rising == 1);
+    CHECK(cusum_rising == 1);
+}
+
+AILLE_TEST(per_decision_buckets_feed_the_detectors) {
+    AlertingConfig cfg;
+    cfg.bucket_decisions = 200;   // binomial bucket rates, near-normal at this size
+    AlertingEngine engine(cfg);
+    AlertLog alert_log(engine);
+    std::mt19937 rng(46);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    uint64_t t = 1000000000ULL;
+    auto run = [&](int decisions, double fallback_p) {
+        for (int i = 0; i < decisions; ++i) {
+            AILLE::Decision d;
+            d.status = unit(rng) < fallback_p ? AILLE::FALLBACK_ACTIVATED : AILLE::DECISION_VALID;
+            d.confidence = 0.8f;
+            d.timestamp_ns = t++;
+            engine.observeDecision(d);
+        }
+    };
+    run(200 * 300, 0.05);
+    CHECK(engine.getBucketIndex() == 300);
+    std::vector<Alert> before = alert_log.drain();
+    run(200 * 20, 0.40);
+
+    std::vector<Alert> after = alert_log.drain();
+    CHECK(before.size() <= 1);
+    const Alert* cusum = first(after, AILLE::ALERT_FALLBACK_RATE, AILLE::DETECTOR_CUSUM);
+    const Alert* ewma = first(after, AILLE::ALERT_FALLBACK_RATE, AILLE::DETECTOR_EWMA);
+    CHECK(cusum != nullptr && cusum->direction == AILLE::ALERT_RISING);
+    CHECK(ewma != nullptr && ewma->direction == AILLE::ALERT_RISING);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
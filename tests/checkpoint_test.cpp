@@ -0,0 +1,193 @@
+/*
+ * AILLE Metrics Checkpoint Tests
+ *
+ * saveState() / loadState() round trips, rejection of corrupt and
+ * incompatible images, and the file-level checkpoint helpers.
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_checkpoint.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::MetricsConfig;
+using AILLE::MetricsSnapshot;
+
+MetricsConfig checkpointConfig() {
+    MetricsConfig cfg;
+    cfg.confidence_window = 500;
+    cfg.rolling_window_buckets = 120;
+    cfg.latency_by_status = true;
+    return cfg;
+}
+
+// Engine-driven decisions with model outcomes and latencies, stamped one
+// every 100 ms from a fixed base so rolling windows are reproducible
+void feed(MetricsCollector& collector, int decisions, uint32_t seed) {
+    AILLE::AILLEEngine engine;
+    engine.setObserver(&collector);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (int i = 0; i < decisions; ++i) {
+        std::vector<AILLE::ModelSignal> signals;
+        float majority = unit(rng) < 0.7f ? 1.0f : -1.0f;
+        for (int m = 0; m < 5; ++m) {
+            float sign = unit(rng) < 0.8f ? majority : -majority;
+            signals.emplace_back(sign * 0.02f * unit(rng), 0.2f + 0.75f * unit(rng), m);
+        }
+        AILLE::Decision d = engine.makeDecision(signals);
+        d.timestamp_ns = 1000000000000ULL + static_cast<uint64_t>(i) * 100000000ULL;
+        collector.observeDecision(d);
+    }
+}
+
+void checkSameSnapshot(const MetricsSnapshot& a, const MetricsSnapshot& b) {
+    CHECK(a.total_decisions == b.total_decisions);
+    CHECK(a.valid_decisions == b.valid_decisions);
+    CHECK(a.fallback_activations == b.fallback_activations);
+    CHECK(a.rejected_confidence == b.rejected_confidence);
+    CHECK(a.rejected_consensus == b.rejected_consensus);
+    CHECK(a.sampled_decisions == b.sampled_decisions);
+    CHECK(a.last_decision_timestamp_ns == b.last_decision_timestamp_ns);
+    CHECK(a.average_confidence == b.average_confidence);
+    CHECK(a.min_confidence == b.min_confidence);
+    CHECK(a.max_confidence == b.max_confidence);
+    CHECK(a.confidence_percentiles.p99 == b.confidence_percentiles.p99);
+    CHECK(a.final_value_percentiles.p50 == b.final_value_percentiles.p50);
+    CHECK(a.latency_ns_percentiles.count == b.latency_ns_percentiles.count);
+    CHECK(a.latency_ns_percentiles.p90 == b.latency_ns_percentiles.p90);
+    for (int i = 0; i < AILLE::DECISION_STATUS_COUNT; ++i) {
+        CHECK(a.latency_ns_by_status[i].count == b.latency_ns_by_status[i].count);
+    }
+    CHECK(a.fallback_regimes.fallback_episodes == b.fallback_regimes.fallback_episodes);
+    CHECK(a.fallback_regimes.time_in_fallback_ns == b.fallback_regimes.time_in_fallback_ns);
+    CHECK(a.fallback_regimes.longest_fallback_streak == b.fallback_regimes.longest_fallback_streak);
+}
+
+AILLE_TEST(round_trip_restores_every_feature) {
+    MetricsCollector original(checkpointConfig());
+    feed(original, 2000, 1);
+    std::vector<uint8_t> image = original.saveState();
+
+    MetricsCollector restored(checkpointConfig());
+    CHECK(restored.loadState(image));
+    checkSameSnapshot(original.getSnapshot(), restored.getSnapshot());
+
+    CHECK(original.getConfidenceQuantile(0.9) == restored.getConfidenceQuantile(0.9));
+    for (int m = 0; m < 5; ++m) {
+        AILLE::ModelHealth a = original.getModelHealth(m);
+        AILLE::ModelHealth b = restored.getModelHealth(m);
+        CHECK(a.signals() > 0);
+        CHECK(a.passed == b.passed && a.grace == b.grace && a.rejected == b.rejected &&
+              a.disagreed == b.disagreed);
+    }
+
+    uint64_t now = original.getSnapshot().last_decision_timestamp_ns;
+    MetricsSnapshot wa = original.getSnapshot(std::chrono::seconds(30), now);
+    MetricsSnapshot wb = restored.getSnapshot(std::chrono::seconds(30), now);
+    CHECK(wa.total_decisions == 300);
+    CHECK(wa.total_decisions == wb.total_decisions);
+    CHECK(wa.confidence_percentiles.p50 == wb.confidence_percentiles.p50);
+
+    // Re-encoding is stable once restored (a restore clears the regime
+    // clock's last timestamp, so the first image differs in that field)
+    std::vector<uint8_t> reencoded = restored.saveState();
+    CHECK(reencoded.size() == image.size());
+    MetricsCollector again(checkpointConfig());
+    CHECK(again.loadState(reencoded));
+    CHECK(again.saveState() == reencoded);
+}
+
+AILLE_TEST(reused_scratch_matches_fresh_save) {
+    MetricsCollector collector(checkpointConfig());
+    MetricsCollector::StateScratch scratch = collector.makeStateScratch();
+    std::vector<uint8_t> image;
+
+    feed(collector, 300, 2);
+    collector.saveState(image, scratch);
+    CHECK(image == collector.saveState());
+
+    feed(collector, 700, 3);
+    collector.saveState(image, scratch);
+    CHECK(image == collector.saveState());
+}
+
+AILLE_TEST(corrupt_image_is_rejected_and_leaves_state) {
+    MetricsCollector source(checkpointConfig());
+    feed(source, 500, 4);
+    std::vector<uint8_t> image = source.saveState();
+
+    MetricsCollector target(checkpointConfig());
+    feed(target, 10, 5);
+
+    std::vector<uint8_t> payload = image;
+    payload[payload.size() / 2] ^= 0x01;
+    CHECK(!target.loadState(payload));
+
+    std::vector<uint8_t> checksum = image;
+    checksum.back() ^= 0x80;
+    CHECK(!target.loadState(checksum));
+
+    std::vector<uint8_t> truncated(image.begin(), image.end() - 9);
+    CHECK(!target.loadState(truncated));
+    CHECK(!target.loadState(nullptr, 0));
+
+    CHECK(target.getSnapshot().total_decisions == 10);
+}
+
+AILLE_TEST(layout_fingerprint_mismatch_is_rejected) {
+    MetricsCollector source(checkpointConfig());
+    feed(source, 200, 6);
+    std::vector<uint8_t> image = source.saveState();
+
+    MetricsConfig other_window = checkpointConfig();
+    other_window.confidence_window = 400;
+    MetricsCollector a(other_window);
+    CHECK(!a.loadState(image));
+
+    MetricsConfig other_latency = checkpointConfig();
+    other_latency.latency_by_status = false;
+    MetricsCollector b(other_latency);
+    CHECK(!b.loadState(image));
+
+    AILLE::CountersOnlyMetricsCollector counters_only(checkpointConfig());
+    CHECK(!counters_only.loadState(image));
+
+    CHECK(a.getSnapshot().total_decisions == 0);
+    CHECK(b.getSnapshot().total_decisions == 0);
+}
+
+#ifdef AILLE_HAS_POSIX_FILES
+AILLE_TEST(checkpoint_file_round_trip) {
+    std::string path = "aille_checkpoint_test.bin";
+    MetricsCollector source(checkpointConfig());
+    feed(source, 400, 7);
+    CHECK(AILLE::saveMetricsCheckpoint(source, path));
+
+    MetricsCollector restored(checkpointConfig());
+    CHECK(AILLE::loadMetricsCheckpoint(restored, path));
+    checkSameSnapshot(source.getSnapshot(), restored.getSnapshot());
+
+    {
+        AILLE::MetricsCheckpointer checkpointer(source, path);
+        feed(source, 100, 8);
+        CHECK(checkpointer.checkpointNow());
+        CHECK(checkpointer.getLastCheckpointBytes() == source.saveState().size());
+    }
+    CHECK(AILLE::loadMetricsCheckpoint(restored, path));
+    CHECK(restored.getSnapshot().total_decisions == 500);
+    std::remove(path.c_str());
+}
+#endif
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
@@ -0,0 +1,112 @@
+/*
+ * AILLE Fallback Regime Tests
+ *
+ * Streak and time-in-regime accounting: the idle-gap cap, decisions that
+ * produced no value, and resuming after a checkpoint restore.
+ */
+
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::FallbackRegimes;
+using AILLE::MetricsCollector;
+using AILLE::MetricsConfig;
+
+constexpr uint64_t BASE_NS = 1000000000000ULL;
+constexpr uint64_t MS = 1000000ULL;
+
+AILLE::Decision decisionAt(AILLE::DecisionStatus status, uint64_t timestamp_ns) {
+    AILLE::Decision d;
+    d.status = status;
+    d.confidence = 0.8f;
+    d.timestamp_ns = timestamp_ns;
+    return d;
+}
+
+AILLE_TEST(streaks_and_time_follow_status_changes) {
+    MetricsCollector collector;
+    uint64_t t = BASE_NS;
+    for (int i = 0; i < 4; ++i, t += 10 * MS) {
+        collector.observeDecision(decisionAt(AILLE::DECISION_VALID, t));
+    }
+    for (int i = 0; i < 3; ++i, t += 10 * MS) {
+        collector.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, t));
+    }
+
+    const FallbackRegimes r = collector.getSnapshot().fallback_regimes;
+    CHECK(r.in_fallback);
+    CHECK(r.current_streak == 3);
+    CHECK(r.longest_normal_streak == 4);
+    CHECK(r.fallback_episodes == 1);
+    // The gap into the first fallback decision belongs to the normal streak
+    CHECK(r.time_in_normal_ns == 40 * MS);
+    CHECK(r.time_in_fallback_ns == 20 * MS);
+    CHECK(r.currentStreakNs() == 20 * MS);
+}
+
+AILLE_TEST(idle_gaps_are_capped) {
+    MetricsConfig cfg;
+    cfg.max_regime_gap_ns = 100 * MS;
+    MetricsCollector collector(cfg);
+    collector.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, BASE_NS));
+    collector.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, BASE_NS + 50 * MS));
+    // An hour of silence counts as one capped gap
+    collector.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, BASE_NS + 3600000 * MS));
+
+    const FallbackRegimes r = collector.getSnapshot().fallback_regimes;
+    CHECK(r.time_in_fallback_ns == 150 * MS);
+    CHECK(r.currentStreakNs() == 150 * MS);
+
+    MetricsConfig uncapped;
+    uncapped.max_regime_gap_ns = 0;
+    MetricsCollector full(uncapped);
+    full.observeDecision(decisionAt(AILLE::DECISION_VALID, BASE_NS));
+    full.observeDecision(decisionAt(AILLE::DECISION_VALID, BASE_NS + 3600000 * MS));
+    CHECK(full.getSnapshot().fallback_regimes.time_in_normal_ns == 3600000 * MS);
+}
+
+AILLE_TEST(no_model_decisions_leave_regimes_untouched) {
+    MetricsCollector collector;
+    collector.observeDecision(decisionAt(AILLE::DECISION_VALID, BASE_NS));
+    collector.observeDecision(decisionAt(AILLE::ERROR_NO_MODELS, BASE_NS + 10 * MS));
+    collector.observeDecision(decisionAt(AILLE::ERROR_NO_MODELS, BASE_NS + 20 * MS));
+    collector.observeDecision(decisionAt(AILLE::DECISION_VALID, BASE_NS + 30 * MS));
+
+    AILLE::MetricsSnapshot s = collector.getSnapshot();
+    CHECK(s.total_decisions == 4);
+    CHECK(s.fallback_activations == 0);
+    CHECK(s.fallback_regimes.current_streak == 2);
+    CHECK(s.fallback_regimes.fallback_episodes == 0);
+    CHECK(s.fallback_regimes.time_in_normal_ns == 30 * MS);
+}
+
+AILLE_TEST(restore_does_not_charge_downtime) {
+    MetricsConfig cfg;
+    cfg.max_regime_gap_ns = 0;
+    MetricsCollector before(cfg);
+    before.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, BASE_NS));
+    before.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, BASE_NS + 20 * MS));
+    std::vector<uint8_t> image = before.saveState();
+
+    MetricsCollector after(cfg);
+    CHECK(after.loadState(image));
+    // Restarted ten minutes later
+    uint64_t restart = BASE_NS + 600000 * MS;
+    after.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, restart));
+    after.observeDecision(decisionAt(AILLE::FALLBACK_ACTIVATED, restart + 5 * MS));
+
+    const FallbackRegimes r = after.getSnapshot().fallback_regimes;
+    CHECK(r.current_streak == 4);
+    CHECK(r.fallback_episodes == 1);
+    CHECK(r.time_in_fallback_ns == 25 * MS);
+    CHECK(r.currentStreakNs() == 25 * MS);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
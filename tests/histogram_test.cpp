@@ -0,0 +1,169 @@
+/*
+ * AILLE Log-Linear Histogram Tests
+ *
+ * Bucket boundaries (exact range, linear sub-buckets per power of two,
+ * clamping), the relative-error bound, merging, and encode()/decode().
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "extensions/aille_histogram.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::HistogramConfig;
+using AILLE::LogLinearHistogram;
+
+// unit 1, 3 bits: exact below 8, then 4 sub-buckets per power of two
+// ([8,9] [10,11] ... then [16,19] [20,23] ...)
+HistogramConfig smallConfig() { return HistogramConfig(1.0, 31.0, 3); }
+
+// Reported values of a and b, bracketed by the smallest and largest
+// tracked values so clamping to the recorded range never applies
+void reported(const HistogramConfig& cfg, double a, double b, double& ra, double& rb) {
+    LogLinearHistogram h(cfg);
+    h.record(0.0);
+    h.record(a);
+    h.record(b);
+    h.record(cfg.max_value);
+    ra = h.percentile(50.0);
+    rb = h.percentile(75.0);
+}
+
+AILLE_TEST(bucket_layout) {
+    LogLinearHistogram h(smallConfig());
+    // 8 exact + (31 >> 2 = 7) + 1 for the top power of two: 16 buckets
+    CHECK(h.getBucketCount() == 16);
+
+    HistogramConfig negative = smallConfig();
+    negative.allow_negative = true;
+    CHECK(LogLinearHistogram(negative).getBucketCount() == 32);
+}
+
+AILLE_TEST(bucket_boundaries) {
+    // Below 2^precision_bits every integer has its own bucket
+    for (double v = 0.0; v < 8.0; v += 1.0) {
+        LogLinearHistogram h(smallConfig());
+        h.record(v);
+        h.record(v);
+        h.record(31.0);
+        CHECK(h.percentile(50.0) == v);
+    }
+
+    // Bucket midpoints: 8 and 9 share [8,9]; 10 starts [10,11]
+    double ra, rb;
+    reported(smallConfig(), 8.0, 9.0, ra, rb);
+    CHECK(ra == 8.5 && rb == 8.5);
+    reported(smallConfig(), 9.0, 10.0, ra, rb);
+    CHECK(ra == 8.5 && rb == 10.5);
+    // Width 4 from 16: 16..19 share [16,19]; 20 starts [20,23]
+    reported(smallConfig(), 16.0, 19.0, ra, rb);
+    CHECK(ra == 17.5 && rb == 17.5);
+    reported(smallConfig(), 19.0, 20.0, ra, rb);
+    CHECK(ra == 17.5 && rb == 21.5);
+
+    // Values are quantized to the nearest multiple of the unit
+    reported(HistogramConfig(0.5, 100.0, 3), 1.24, 1.26, ra, rb);
+    CHECK(ra == 1.0 && rb == 1.5);
+}
+
+AILLE_TEST(values_beyond_max_clamp_to_top_bucket) {
+    LogLinearHistogram h(smallConfig());
+    h.record(1000.0);
+    h.record(5000.0);
+    CHECK(h.getTotalCount() == 2);
+    CHECK(h.getMax() == 5000.0);
+    CHECK(h.getSum() == 6000.0);
+    // Top bucket [28, 31] reports its midpoint, clamped to the recorded range
+    CHECK(h.percentile(50.0) == 1000.0);
+
+    // Negative values clamp to zero unless mirrored buckets are enabled
+    LogLinearHistogram positive(smallConfig());
+    positive.record(-3.0);
+    CHECK(positive.getTotalCount() == 1);
+    CHECK(positive.getMin() == -3.0);
+}
+
+AILLE_TEST(relative_error_bound) {
+    const int bits = 7;
+    LogLinearHistogram h(HistogramConfig(1.0, 1e9, bits));
+    std::vector<double> values;
+    std::mt19937_64 rng(21);
+    std::lognormal_distribution<double> latency(10.0, 2.0);
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back(std::round(latency(rng)) + 1.0);
+        h.record(values.back());
+    }
+    std::sort(values.begin(), values.end());
+
+    double bound = std::ldexp(1.0, -bits);
+    for (double p : {1.0, 10.0, 50.0, 90.0, 99.0, 99.9}) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+        double exact = values[rank - 1];
+        CHECK(std::fabs(h.percentile(p) - exact) <= bound * exact + 0.5);
+    }
+    CHECK(h.percentile(100.0) == values.back());
+}
+
+AILLE_TEST(merge_adds_counts) {
+    HistogramConfig cfg(1.0, 1e6, 5, true);
+    LogLinearHistogram a(cfg);
+    LogLinearHistogram b(cfg);
+    LogLinearHistogram both(cfg);
+    for (int i = -500; i < 1500; ++i) {
+        double v = i * 3.0;
+        (i % 2 ? a : b).record(v);
+        both.record(v);
+    }
+    CHECK(a.merge(b));
+    CHECK(a.getTotalCount() == both.getTotalCount());
+    CHECK(a.getMin() == both.getMin() && a.getMax() == both.getMax());
+    CHECK(a.getSum() == both.getSum());
+    for (double p : {0.1, 25.0, 50.0, 75.0, 99.9}) CHECK(a.percentile(p) == both.percentile(p));
+
+    LogLinearHistogram other(HistogramConfig(1.0, 1e6, 6, true));
+    CHECK(!a.merge(other));
+    CHECK(a.getTotalCount() == both.getTotalCount());
+}
+
+AILLE_TEST(encode_decode_round_trip) {
+    HistogramConfig cfg(0.001, 10.0, 7, true);
+    LogLinearHistogram h(cfg);
+    std::mt19937 rng(22);
+    std::normal_distribution<double> dist(0.0, 2.0);
+    for (int i = 0; i < 20000; ++i) h.record(dist(rng));
+
+    std::vector<uint8_t> bytes = h.encode();
+    LogLinearHistogram decoded;
+    CHECK(LogLinearHistogram::decode(bytes.data(), bytes.size(), decoded));
+    CHECK(decoded.isCompatible(h));
+    CHECK(decoded.getTotalCount() == h.getTotalCount());
+    CHECK(decoded.getSum() == h.getSum());
+    CHECK(decoded.getMin() == h.getMin() && decoded.getMax() == h.getMax());
+    for (double p : {0.1, 1.0, 50.0, 99.0, 99.99}) CHECK(decoded.percentile(p) == h.percentile(p));
+    CHECK(decoded.encode() == bytes);
+
+    // Sparse: 64-byte header plus 12 bytes per non-empty bucket
+    CHECK(LogLinearHistogram(cfg).encode().size() == 64);
+    CHECK((bytes.size() - 64) % 12 == 0);
+
+    // Truncated, wrong-magic and out-of-range images are rejected
+    LogLinearHistogram untouched;
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    CHECK(!LogLinearHistogram::decode(truncated.data(), truncated.size(), untouched));
+    std::vector<uint8_t> bad_magic = bytes;
+    bad_magic[0] ^= 0xff;
+    CHECK(!LogLinearHistogram::decode(bad_magic.data(), bad_magic.size(), untouched));
+    std::vector<uint8_t> bad_index = bytes;
+    bad_index[64 + 2] = 0x7f;   // first entry's index, far beyond the bucket count
+    CHECK(!LogLinearHistogram::decode(bad_index.data(), bad_index.size(), untouched));
+    CHECK(untouched.getTotalCount() == 0);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
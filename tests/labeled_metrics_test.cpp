@@ -0,0 +1,202 @@
+/*
+ * AILLE Labeled Metric Family Tests
+ *
+ * Bounded cardinality (labels past max_labels fold into "other"), top-N
+ * ranking, reset() and its probe epoch, and concurrent first inserts of
+ * the same label landing in exactly one slot.
+ */
+
+#include <atomic>
+#include <functional>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_labeled_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::LabeledMetrics;
+using AILLE::LabelStats;
+
+AILLE::Decision decision(AILLE::DecisionStatus status, float confidence) {
+    AILLE::Decision d;
+    d.status = status;
+    d.confidence = confidence;
+    d.timestamp_ns = 1000000000ULL;
+    return d;
+}
+
+const AILLE::Decision VALID = decision(AILLE::DECISION_VALID, 0.8f);
+
+// Starts every thread's body at once so first inserts overlap
+void runTogether(int threads, const std::function<void(int)>& body) {
+    std::atomic<int> ready{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (ready.load() < threads) std::this_thread::yield();
+            body(t);
+        });
+    }
+    for (std::thread& th : pool) th.join();
+}
+
+AILLE_TEST(labels_beyond_capacity_go_to_other) {
+    LabeledMetrics m(4);
+    for (uint32_t id = 0; id < 10; ++id) m.observeDecision(id, VALID);
+    CHECK(m.getLabelCount() == 4);
+    CHECK(m.getOtherStats().total_decisions == 6);
+
+    int tracked = 0;
+    LabelStats s;
+    for (uint32_t id = 0; id < 10; ++id) tracked += m.getLabelStats(id, s) ? 1 : 0;
+    CHECK(tracked == 4);
+
+    // Labels already in the table keep their own slot once it is full
+    CHECK(m.getLabelStats(0, s));
+    m.observeDecision(0, VALID);
+    CHECK(m.getLabelStats(0, s) && s.total_decisions == 2);
+    m.observeDecision(9, VALID);
+    CHECK(m.getOtherStats().total_decisions == 7);
+
+    // The invalid label ID is always "other"
+    m.observeDecision(AILLE::LabelRegistry::INVALID_LABEL, VALID);
+    CHECK(m.getOtherStats().total_decisions == 8);
+    CHECK(!m.getLabelStats(AILLE::LabelRegistry::INVALID_LABEL, s));
+}
+
+AILLE_TEST(top_n_orders_by_ranking) {
+    LabeledMetrics m(16);
+    // Label i: 10 + i decisions, i of them fallbacks, confidence 0.9 - 0.05 i
+    for (uint32_t id = 0; id < 6; ++id) {
+        float conf = 0.9f - 0.05f * id;
+        for (uint32_t k = 0; k < 10 + id; ++k) {
+            AILLE::DecisionStatus status =
+                k < id ? AILLE::FALLBACK_ACTIVATED : AILLE::DECISION_VALID;
+            m.observeDecision(id, decision(status, conf));
+        }
+    }
+
+    std::vector<LabelStats> top = m.topN(3);
+    CHECK(top.size() == 3);
+    if (top.size() == 3) {
+        CHECK(top[0].label_id == 5 && top[0].total_decisions == 15);
+        CHECK(top[1].label_id == 4);
+        CHECK(top[2].label_id == 3);
+    }
+
+    top = m.topN(2, AILLE::RANK_BY_FALLBACK_RATE);
+    CHECK(top.size() == 2 && top[0].label_id == 5 && top[1].label_id == 4);
+    top = m.topN(1, AILLE::RANK_BY_FALLBACKS);
+    CHECK(top.size() == 1 && top[0].fallback_activations == 5);
+    top = m.topN(2, AILLE::RANK_BY_LOW_CONFIDENCE);
+    CHECK(top.size() == 2 && top[0].label_id == 5 && top[1].label_id == 4);
+
+    // Asking for more than exist returns every label
+    CHECK(m.topN(100).size() == 6);
+}
+
+AILLE_TEST(reset_clears_labels_and_other) {
+    LabeledMetrics m(2);
+    for (uint32_t id = 0; id < 5; ++id) m.observeDecision(id, VALID);
+    m.reset();
+
+    LabelStats s;
+    CHECK(m.getLabelCount() == 0);
+    CHECK(m.getOtherStats().total_decisions == 0);
+    CHECK(!m.getLabelStats(0, s));
+    CHECK(m.topN(10).empty());
+
+    // Capacity is available again, and counts start from zero
+    m.observeDecision(3, VALID);
+    m.observeDecision(4, VALID);
+    m.observeDecision(0, VALID);
+    CHECK(m.getLabelCount() == 2);
+    CHECK(m.getLabelStats(3, s) && s.total_decisions == 1);
+    CHECK(m.getOtherStats().total_decisions == 1);
+}
+
+AILLE_TEST(concurrent_first_inserts_share_one_slot) {
+    const int threads = 8;
+    const int per_thread = 20000;
+    LabeledMetrics m(64);
+    runTogether(threads, [&](int) {
+        for (int i = 0; i < per_thread; ++i) m.observeDecision(42, VALID);
+    });
+
+    LabelStats s;
+    CHECK(m.getLabelCount() == 1);
+    CHECK(m.getLabelStats(42, s) && s.total_decisions == uint64_t(threads) * per_thread);
+    CHECK(m.topN(10).size() == 1);
+    CHECK(m.getOtherStats().total_decisions == 0);
+}
+
+AILLE_TEST(concurrent_inserts_of_many_labels_are_exact) {
+    // Every thread inserts the same 300 labels in a different order, so
+    // claims collide on slots and stripes
+    const int threads = 6;
+    const uint32_t labels = 300;
+    LabeledMetrics m(labels);
+    runTogether(threads, [&](int t) {
+        for (int round = 0; round < 10; ++round) {
+            for (uint32_t k = 0; k < labels; ++k) {
+                m.observeDecision((k * 7 + static_cast<uint32_t>(t) * 31) % labels, VALID);
+            }
+        }
+    });
+
+    CHECK(m.getLabelCount() == labels);
+    CHECK(m.getOtherStats().total_decisions == 0);
+    std::vector<LabelStats> all = m.topN(labels * 2);
+    CHECK(all.size() == labels);
+    std::set<uint32_t> seen;
+    for (const LabelStats& s : all) {
+        seen.insert(s.label_id);
+        CHECK(s.total_decisions == uint64_t(threads) * 10);
+    }
+    CHECK(seen.size() == labels);
+}
+
+AILLE_TEST(reset_during_inserts_never_duplicates_a_label) {
+    // Probes that straddle a reset() restart from the home slot, so a
+    // label never ends up in two slots. A small table keeps reset()
+    // frequent relative to inserts.
+    const uint32_t labels = 16;
+    LabeledMetrics m(labels);
+    std::atomic<bool> stop{false};
+    std::thread resetter([&]() {
+        while (!stop.load()) {
+            m.reset();
+            std::this_thread::yield();
+        }
+    });
+    runTogether(4, [&](int t) {
+        for (int round = 0; round < 2000; ++round) {
+            for (uint32_t k = 0; k < labels; ++k) {
+                m.observeDecision((k + static_cast<uint32_t>(t) * 5) % labels, VALID);
+            }
+        }
+    });
+    stop.store(true);
+    resetter.join();
+
+    // Quiescent now: check the table after the last reset
+    std::vector<LabelStats> all = m.topN(labels * 2);
+    std::set<uint32_t> seen;
+    for (const LabelStats& s : all) seen.insert(s.label_id);
+    CHECK(seen.size() == all.size());
+    CHECK(all.size() == m.getLabelCount());
+    CHECK(m.getLabelCount() <= labels);
+
+    for (uint32_t k = 0; k < labels; ++k) m.observeDecision(k, VALID);
+    CHECK(m.getLabelCount() == labels);
+    CHECK(m.getOtherStats().total_decisions == 0);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
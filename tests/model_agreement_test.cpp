@@ -0,0 +1,159 @@
+/*
+ * AILLE Pairwise Model Agreement Tests
+ *
+ * Sign agreement, covariance and correlation against values computed
+ * directly from the same signals, cumulatively and with the exponential
+ * window, plus pairs that only sometimes appear together.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_model_agreement.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::ModelAgreementConfig;
+using AILLE::ModelAgreementMatrix;
+using AILLE::ModelPairStats;
+using AILLE::ModelSignal;
+
+// Weighted reference over decisions where both models appeared
+struct PairReference {
+    double n = 0.0, agree = 0.0, sa = 0.0, sb = 0.0, sab = 0.0, saa = 0.0, sbb = 0.0;
+
+    void add(double a, double b, double w) {
+        n += w;
+        agree += ((a >= 0) == (b >= 0)) ? w : 0.0;
+        sa += w * a;
+        sb += w * b;
+        sab += w * a * b;
+        saa += w * a * a;
+        sbb += w * b * b;
+    }
+
+    // Older decisions lose weight by `decay` per update
+    void decay(double d) {
+        n *= d;
+        agree *= d;
+        sa *= d;
+        sb *= d;
+        sab *= d;
+        saa *= d;
+        sbb *= d;
+    }
+
+    void check(const ModelPairStats& p) const {
+        double mean_a = sa / n, mean_b = sb / n;
+        double cov = sab / n - mean_a * mean_b;
+        double var_a = saa / n - mean_a * mean_a;
+        double var_b = sbb / n - mean_b * mean_b;
+        CHECK_NEAR(p.weight / n, 1.0, 1e-9);
+        CHECK_NEAR(p.agreement_rate, agree / n, 1e-9);
+        CHECK_NEAR(p.mean_a, mean_a, 1e-9);
+        CHECK_NEAR(p.mean_b, mean_b, 1e-9);
+        CHECK_NEAR(p.covariance, cov, 1e-9);
+        CHECK_NEAR(p.correlation, cov / std::sqrt(var_a * var_b), 1e-6);
+    }
+};
+
+AILLE_TEST(cumulative_matrix_matches_direct_computation) {
+    ModelAgreementConfig cfg;
+    cfg.max_models = 8;
+    ModelAgreementMatrix matrix(cfg);
+
+    std::mt19937 rng(31);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    PairReference ref01, ref02, ref03, ref34;
+    int together34 = 0;
+
+    for (int i = 0; i < 5000; ++i) {
+        // Signals are floats; the reference sees exactly what the matrix sees
+        float x = static_cast<float>(noise(rng));
+        float v[5] = {x, static_cast<float>(2.0 * x + 0.1 * noise(rng)), -x,
+                      static_cast<float>(noise(rng)), static_cast<float>(noise(rng))};
+        std::vector<ModelSignal> signals;
+        for (int id = 0; id < 4; ++id) signals.emplace_back(v[id], 0.9f, id);
+        if (unit(rng) < 0.3) {
+            signals.emplace_back(v[4], 0.9f, 4);
+            ref34.add(v[3], v[4], 1.0);
+            together34++;
+        }
+        ref01.add(v[0], v[1], 1.0);
+        ref02.add(v[0], v[2], 1.0);
+        ref03.add(v[0], v[3], 1.0);
+        matrix.observe(signals);
+    }
+    matrix.publish();
+
+    AILLE::ModelAgreementSnapshot s = matrix.getSnapshot();
+    CHECK(s.generation > 0);
+    CHECK(s.updates == 5000);
+    ref01.check(s.pair(0, 1));
+    ref02.check(s.pair(0, 2));
+    ref03.check(s.pair(0, 3));
+    ref34.check(s.pair(3, 4));
+
+    CHECK(s.pair(0, 1).correlation > 0.99);
+    CHECK(s.pair(0, 2).correlation < -0.999);
+    CHECK(s.pair(0, 2).agreement_rate < 0.001);
+    CHECK(std::fabs(s.pair(0, 3).correlation) < 0.05);
+    CHECK(s.pair(3, 4).weight == together34);
+    // The matrix is symmetric, and absent models have no pairs
+    CHECK(s.agreementRate(1, 0) == s.agreementRate(0, 1));
+    CHECK(s.pair(0, 6).weight == 0.0);
+}
+
+AILLE_TEST(windowed_matrix_tracks_regime_change) {
+    ModelAgreementConfig cfg;
+    cfg.max_models = 4;
+    cfg.window_decisions = 200;
+    ModelAgreementMatrix matrix(cfg);
+    const double decay = 1.0 - 1.0 / cfg.window_decisions;
+
+    std::mt19937 rng(32);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    PairReference ref;
+    for (int i = 0; i < 4000; ++i) {
+        // Models 0 and 1 agree for the first half and oppose after
+        float x = static_cast<float>(noise(rng));
+        float y = static_cast<float>((i < 2000 ? 1.0 : -1.0) * x + 0.2 * noise(rng));
+        ref.decay(decay);
+        ref.add(x, y, 1.0);
+        matrix.observe({ModelSignal(x, 0.9f, 0), ModelSignal(y, 0.9f, 1)});
+        if (i == 1999) {
+            matrix.publish();
+            CHECK(matrix.getSnapshot().correlation(0, 1) > 0.95);
+        }
+    }
+    matrix.publish();
+
+    ModelPairStats p = matrix.getSnapshot().pair(0, 1);
+    // Weights are relative; the reference only matches up to that scale
+    PairReference scaled = ref;
+    scaled.decay(p.weight / ref.n);
+    scaled.check(p);
+    CHECK(p.correlation < -0.95);
+    CHECK(p.agreement_rate < 0.2);
+}
+
+AILLE_TEST(out_of_range_and_non_finite_signals_are_ignored) {
+    ModelAgreementConfig cfg;
+    cfg.max_models = 2;
+    ModelAgreementMatrix matrix(cfg);
+    matrix.observe({ModelSignal(1.0f, 0.9f, 0), ModelSignal(1.0f, 0.9f, 1),
+                    ModelSignal(1.0f, 0.9f, 7), ModelSignal(NAN, 0.9f, 1)});
+    matrix.publish();
+    AILLE::ModelAgreementSnapshot s = matrix.getSnapshot();
+    CHECK(s.models == 2);
+    CHECK(s.pair(0, 1).weight == 1.0);
+    CHECK(s.pair(0, 1).agreement_rate == 1.0);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
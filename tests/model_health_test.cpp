@@ -0,0 +1,141 @@
+/*
+ * AILLE Per-Model Health Tests
+ *
+ * Outcomes reported by AILLEEngine through DecisionObserver (passed,
+ * grace, rejected, disagreed with the consensus median), the fixed
+ * table's shared slot for out-of-range model IDs, getModelHealthTable(),
+ * reset(), concurrent reporters, and policies without the table.
+ */
+
+#include <thread>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::ModelHealth;
+using AILLE::ModelSignal;
+
+// Default thresholds: pass at 0.35, grace at 0.25. Model 0 passes,
+// model 1 is in the grace band, model 2 is rejected and model 3 passes
+// but has the opposite sign to the (positive) median.
+std::vector<ModelSignal> mixedSignals() {
+    return {ModelSignal(0.5f, 0.9f, 0), ModelSignal(0.4f, 0.3f, 1),
+            ModelSignal(0.2f, 0.1f, 2), ModelSignal(-0.3f, 0.8f, 3)};
+}
+
+AILLE_TEST(engine_reports_each_outcome) {
+    AILLE::AILLEEngine engine;
+    MetricsCollector collector;
+    engine.setObserver(&collector);
+    for (int i = 0; i < 10; ++i) engine.makeDecision(mixedSignals());
+
+    ModelHealth passed = collector.getModelHealth(0);
+    CHECK(passed.model_id == 0);
+    CHECK(passed.passed == 10 && passed.grace == 0 && passed.rejected == 0);
+    CHECK(passed.disagreed == 0);
+    CHECK(passed.passRate() == 1.0f);
+
+    ModelHealth grace = collector.getModelHealth(1);
+    CHECK(grace.grace == 10 && grace.signals() == 10);
+    CHECK(grace.graceRate() == 1.0f);
+
+    ModelHealth rejected = collector.getModelHealth(2);
+    CHECK(rejected.rejected == 10 && rejected.signals() == 10);
+    CHECK(rejected.rejectRate() == 1.0f);
+    // Rejected signals never reach consensus, so they cannot disagree
+    CHECK(rejected.disagreed == 0 && rejected.disagreeRate() == 0.0f);
+
+    ModelHealth dissenter = collector.getModelHealth(3);
+    CHECK(dissenter.passed == 10 && dissenter.disagreed == 10);
+    CHECK(dissenter.disagreeRate() == 1.0f);
+
+    // Unused IDs report nothing
+    CHECK(collector.getModelHealth(7).signals() == 0);
+
+    // Detached: no further outcomes
+    engine.setObserver(nullptr);
+    engine.makeDecision(mixedSignals());
+    CHECK(collector.getModelHealth(0).passed == 10);
+}
+
+AILLE_TEST(thresholds_are_inclusive) {
+    AILLE::AILLEEngine engine;
+    MetricsCollector collector;
+    engine.setObserver(&collector);
+    AILLE::AILLEConfig cfg = engine.getConfig();
+    engine.makeDecision({ModelSignal(0.5f, cfg.min_confidence_threshold, 0),
+                         ModelSignal(0.5f, cfg.grace_confidence_threshold, 1)});
+    CHECK(collector.getModelHealth(0).passed == 1);
+    CHECK(collector.getModelHealth(1).grace == 1);
+}
+
+AILLE_TEST(out_of_range_ids_share_one_slot) {
+    const int max_ids = AILLE::ModelHealthTable::MAX_MODEL_IDS;
+    MetricsCollector collector;
+    collector.onModelOutcome(max_ids, AILLE::MODEL_PASSED);
+    collector.onModelOutcome(-5, AILLE::MODEL_REJECTED);
+    AILLE::ModelOutcomeReport reports[] = {{max_ids + 100, AILLE::MODEL_GRACE},
+                                           {max_ids - 1, AILLE::MODEL_PASSED},
+                                           {2, AILLE::MODEL_REJECTED}};
+    collector.onModelOutcomes(reports, 3);
+
+    ModelHealth shared = collector.getModelHealth(1000);
+    CHECK(shared.model_id == -1);
+    CHECK(shared.passed == 1 && shared.grace == 1 && shared.rejected == 1);
+    CHECK(collector.getModelHealth(-1).signals() == 3);
+    CHECK(collector.getModelHealth(max_ids - 1).passed == 1);
+
+    // Only models with signals, by ID, the shared slot last
+    std::vector<ModelHealth> table = collector.getModelHealthTable();
+    CHECK(table.size() == 3);
+    if (table.size() == 3) {
+        CHECK(table[0].model_id == 2 && table[0].rejected == 1);
+        CHECK(table[1].model_id == max_ids - 1);
+        CHECK(table[2].model_id == -1 && table[2].signals() == 3);
+    }
+
+    collector.reset();
+    CHECK(collector.getModelHealthTable().empty());
+    CHECK(collector.getModelHealth(1000).signals() == 0);
+}
+
+AILLE_TEST(concurrent_reporters_are_counted_exactly) {
+    const int threads = 4;
+    const int per_thread = 50000;
+    MetricsCollector collector;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&collector, t]() {
+            AILLE::ModelOutcomeReport reports[] = {{t, AILLE::MODEL_PASSED},
+                                                   {9, AILLE::MODEL_GRACE}};
+            for (int i = 0; i < per_thread; ++i) collector.onModelOutcomes(reports, 2);
+        });
+    }
+    for (std::thread& th : pool) th.join();
+
+    for (int t = 0; t < threads; ++t) CHECK(collector.getModelHealth(t).passed == per_thread);
+    CHECK(collector.getModelHealth(9).grace == uint64_t(threads) * per_thread);
+}
+
+AILLE_TEST(policies_without_the_table_report_empty_health) {
+    AILLE::CountersOnlyMetricsCollector counters;
+    AILLE::AILLEEngine engine;
+    engine.setObserver(&counters);
+    engine.makeDecision(mixedSignals());
+    ModelHealth h = counters.getModelHealth(0);
+    CHECK(h.model_id == 0 && h.signals() == 0);
+    CHECK(counters.getModelHealthTable().empty());
+
+    AILLE::NullMetricsCollector null;
+    null.onModelOutcome(0, AILLE::MODEL_PASSED);
+    CHECK(null.getModelHealth(0).signals() == 0);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
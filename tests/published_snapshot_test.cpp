@@ -0,0 +1,139 @@
+/*
+ * AILLE Published Snapshot Tests
+ *
+ * The double-buffered PublishedSnapshot under readers racing the
+ * publisher (no torn copies, generations never go backwards) and the
+ * collector's publishSnapshot() / getPublishedSnapshot() / startPublishing().
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::MetricsSnapshot;
+using AILLE::PublishedSnapshot;
+
+// Every field a torn copy could mix up is derived from the generation
+MetricsSnapshot stamped(uint64_t g) {
+    MetricsSnapshot s;
+    s.total_decisions = g;
+    s.valid_decisions = 2 * g;
+    s.fallback_activations = 3 * g;
+    s.last_decision_timestamp_ns = g;
+    for (uint64_t& b : s.models_agreed_histogram.buckets) b = g;
+    s.latency_ns_by_status[AILLE::DECISION_STATUS_COUNT - 1].count = g;
+    return s;
+}
+
+bool consistent(const MetricsSnapshot& s, uint64_t g) {
+    if (s.total_decisions != g || s.valid_decisions != 2 * g ||
+        s.fallback_activations != 3 * g || s.last_decision_timestamp_ns != g) {
+        return false;
+    }
+    for (uint64_t b : s.models_agreed_histogram.buckets) {
+        if (b != g) return false;
+    }
+    return s.latency_ns_by_status[AILLE::DECISION_STATUS_COUNT - 1].count == g;
+}
+
+AILLE::Decision validDecision(uint64_t timestamp_ns) {
+    AILLE::Decision d;
+    d.status = AILLE::DECISION_VALID;
+    d.confidence = 0.7f;
+    d.timestamp_ns = timestamp_ns;
+    return d;
+}
+
+AILLE_TEST(readers_racing_the_publisher_never_see_torn_copies) {
+    PublishedSnapshot published;
+    MetricsSnapshot empty;
+    CHECK(published.read(empty) == 0);
+    CHECK(empty.total_decisions == 0);
+
+    const uint64_t generations = 100000;
+    const int readers = 3;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0}, backwards{0}, reads{0};
+
+    std::vector<std::thread> pool;
+    for (int r = 0; r < readers; ++r) {
+        pool.emplace_back([&]() {
+            MetricsSnapshot out;
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                uint64_t g = published.read(out);
+                if (g == 0) continue;
+                if (!consistent(out, g)) torn.fetch_add(1);
+                if (g < last) backwards.fetch_add(1);
+                last = g;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (uint64_t g = 1; g <= generations; ++g) {
+        published.publish(stamped(g));
+        if (g % 64 == 0) std::this_thread::yield();   // let readers interleave
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& t : pool) t.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(backwards.load() == 0);
+    CHECK(reads.load() > 0);
+    CHECK(published.getGeneration() == generations);
+    MetricsSnapshot last;
+    CHECK(published.read(last) == generations && consistent(last, generations));
+}
+
+AILLE_TEST(collector_publishes_on_demand) {
+    MetricsCollector collector;
+    MetricsSnapshot out;
+    CHECK(collector.getPublishedSnapshot(out) == 0);
+    CHECK(collector.getPublishedGeneration() == 0);
+
+    for (int i = 0; i < 10; ++i) collector.observeDecision(validDecision(1000000000ULL + i));
+    CHECK(collector.publishSnapshot() == 1);
+
+    // Later decisions stay invisible until the next publication
+    for (int i = 0; i < 5; ++i) collector.observeDecision(validDecision(2000000000ULL + i));
+    CHECK(collector.getPublishedSnapshot(out) == 1);
+    CHECK(out.total_decisions == 10);
+    CHECK(out.confidence_percentiles.count == 10);
+
+    CHECK(collector.publishSnapshot() == 2);
+    CHECK(collector.getPublishedSnapshot(out) == 2);
+    CHECK(out.total_decisions == 15);
+    CHECK(out.total_decisions == collector.getSnapshot().total_decisions);
+}
+
+AILLE_TEST(background_publisher_advances_generations) {
+    MetricsCollector collector;
+    collector.observeDecision(validDecision(1000000000ULL));
+    collector.startPublishing(std::chrono::milliseconds(1));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (collector.getPublishedGeneration() < 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    collector.stopPublishing();
+    uint64_t stopped_at = collector.getPublishedGeneration();
+    CHECK(stopped_at >= 3);
+
+    MetricsSnapshot out;
+    CHECK(collector.getPublishedSnapshot(out) == stopped_at);
+    CHECK(out.total_decisions == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(collector.getPublishedGeneration() == stopped_at);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
@@ -0,0 +1,122 @@
+/*
+ * AILLE KLL Quantile Sketch Tests
+ *
+ * Rank error against exact quantiles of the same stream, for one sketch
+ * and for sketches merged from disjoint streams.
+ */
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "extensions/aille_quantile_sketch.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::KllSketch;
+
+// Fractions of `sorted` below and at-or-below v
+double exactRankBelow(const std::vector<float>& sorted, float v) {
+    return static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), v) -
+                               sorted.begin()) /
+           static_cast<double>(sorted.size());
+}
+
+double exactRankAtMost(const std::vector<float>& sorted, float v) {
+    return static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), v) -
+                               sorted.begin()) /
+           static_cast<double>(sorted.size());
+}
+
+// Largest distance between q and the exact rank range of quantile(q) over
+// a grid of q (a value's rank range spans its run of duplicates)
+double maxRankError(const KllSketch& sketch, std::vector<float> values) {
+    std::sort(values.begin(), values.end());
+    double worst = 0.0;
+    for (int i = 1; i < 100; ++i) {
+        double q = i / 100.0;
+        float v = sketch.quantile(q);
+        double lo = exactRankBelow(values, v);
+        double hi = exactRankAtMost(values, v);
+        double err = q < lo ? lo - q : (q > hi ? q - hi : 0.0);
+        worst = std::max(worst, err);
+    }
+    return worst;
+}
+
+AILLE_TEST(small_streams_are_exact) {
+    KllSketch sketch(200);
+    std::vector<float> values;
+    for (int i = 0; i < 150; ++i) {
+        values.push_back(static_cast<float>((i * 37) % 150));
+        sketch.update(values.back());
+    }
+    CHECK(sketch.getN() == 150);
+    CHECK(sketch.getRetainedItems() == 150);
+    CHECK(sketch.getMin() == 0.0f);
+    CHECK(sketch.getMax() == 149.0f);
+    CHECK(maxRankError(sketch, values) == 0.0);
+}
+
+AILLE_TEST(rank_error_within_bound) {
+    const int k = 200;
+    std::mt19937 rng(11);
+    std::lognormal_distribution<float> skewed(0.0f, 1.0f);
+    KllSketch sketch(k, 11);
+    std::vector<float> values;
+    for (int i = 0; i < 200000; ++i) {
+        values.push_back(skewed(rng));
+        sketch.update(values.back());
+    }
+
+    CHECK(sketch.getN() == values.size());
+    CHECK(sketch.getRetainedItems() < values.size() / 50);
+    CHECK(maxRankError(sketch, values) <= KllSketch::getNormalizedRankError(k));
+    CHECK(sketch.quantile(0.0) == *std::min_element(values.begin(), values.end()));
+    CHECK(sketch.quantile(1.0) == *std::max_element(values.begin(), values.end()));
+
+    // rank() is the inverse view of the same error
+    std::vector<float> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    for (double q : {0.1, 0.5, 0.9, 0.99}) {
+        float v = sorted[static_cast<size_t>(q * sorted.size())];
+        CHECK_NEAR(sketch.rank(v), exactRankAtMost(sorted, v),
+                   KllSketch::getNormalizedRankError(k));
+    }
+}
+
+AILLE_TEST(merge_matches_union_of_streams) {
+    const int k = 200;
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> low(0.0f, 1.0f);
+    std::normal_distribution<float> high(5.0f, 0.5f);
+
+    KllSketch a(k, 1);
+    KllSketch b(k, 2);
+    std::vector<float> all;
+    for (int i = 0; i < 120000; ++i) {
+        all.push_back(low(rng));
+        a.update(all.back());
+    }
+    for (int i = 0; i < 40000; ++i) {
+        all.push_back(high(rng));
+        b.update(all.back());
+    }
+
+    a.merge(b);
+    CHECK(a.getN() == all.size());
+    CHECK(a.getMin() == *std::min_element(all.begin(), all.end()));
+    CHECK(a.getMax() == *std::max_element(all.begin(), all.end()));
+    CHECK(maxRankError(a, all) <= KllSketch::getNormalizedRankError(k));
+
+    // Merging into an empty sketch is a copy of the other
+    KllSketch empty(k, 3);
+    empty.merge(b);
+    CHECK(empty.getN() == b.getN());
+    CHECK(empty.quantile(0.5) == b.quantile(0.5));
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
@@ -0,0 +1,155 @@
+/*
+ * AILLE Rolling Window Tests
+ *
+ * Time-bucketed windows keyed by Decision::timestamp_ns: windows of
+ * different lengths over the same ring, bucket reuse as the ring wraps,
+ * expiry past the horizon, late decisions, and truncation to the horizon.
+ */
+
+#include <chrono>
+#include <cmath>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::MetricsConfig;
+using AILLE::MetricsSnapshot;
+using std::chrono::seconds;
+
+constexpr uint64_t SEC = 1000000000ULL;
+constexpr uint64_t BASE_NS = 1000 * SEC;
+
+AILLE::Decision decisionAt(uint64_t timestamp_ns, AILLE::DecisionStatus status,
+                           float confidence = 0.8f) {
+    AILLE::Decision d;
+    d.status = status;
+    d.confidence = confidence;
+    d.timestamp_ns = timestamp_ns;
+    return d;
+}
+
+// 10 one-second buckets: a 10 s horizon
+MetricsConfig tenSeconds() {
+    MetricsConfig cfg;
+    cfg.rolling_window_buckets = 10;
+    cfg.rolling_bucket_ns = SEC;
+    return cfg;
+}
+
+// Second s gets s + 1 decisions; every third second is all fallbacks
+void feedSeconds(MetricsCollector& collector, int seconds_count) {
+    for (int s = 0; s < seconds_count; ++s) {
+        AILLE::DecisionStatus status =
+            s % 3 == 0 ? AILLE::FALLBACK_ACTIVATED : AILLE::DECISION_VALID;
+        for (int k = 0; k <= s; ++k) {
+            collector.observeDecision(decisionAt(BASE_NS + s * SEC + k * 1000, status));
+        }
+    }
+}
+
+AILLE_TEST(windows_cover_their_trailing_buckets) {
+    MetricsCollector collector(tenSeconds());
+    feedSeconds(collector, 10);
+    CHECK(collector.getRollingHorizonNs() == 10 * SEC);
+    uint64_t now = BASE_NS + 9 * SEC + SEC / 2;
+
+    // Last 3 s: seconds 7, 8, 9 -> 8 + 9 + 10 decisions, second 9 falls back
+    MetricsSnapshot last3 = collector.getSnapshot(seconds(3), now);
+    CHECK(last3.window_ns == 3 * SEC);
+    CHECK(last3.total_decisions == 27);
+    CHECK(last3.fallback_activations == 10);
+    CHECK_NEAR(last3.fallback_rate, 10.0 / 27.0, 1e-6);
+    CHECK_NEAR(last3.decisions_per_second, 9.0, 1e-4);
+
+    // The whole horizon matches the lifetime counters
+    MetricsSnapshot all = collector.getSnapshot(seconds(10), now);
+    MetricsSnapshot lifetime = collector.getSnapshot();
+    CHECK(all.total_decisions == 55);
+    CHECK(all.total_decisions == lifetime.total_decisions);
+    CHECK(all.fallback_activations == lifetime.fallback_activations);
+}
+
+AILLE_TEST(old_buckets_expire_and_are_reused) {
+    MetricsCollector collector(tenSeconds());
+    feedSeconds(collector, 10);
+
+    // Second 10 reuses second 0's slot: its one decision leaves the
+    // window as the new one enters
+    collector.observeDecision(decisionAt(BASE_NS + 10 * SEC, AILLE::DECISION_VALID));
+    uint64_t now = BASE_NS + 10 * SEC;
+    MetricsSnapshot wrapped = collector.getSnapshot(seconds(10), now);
+    CHECK(wrapped.total_decisions == 55);
+    CHECK(wrapped.fallback_activations == 1 + 4 + 7 + 10 - 1);
+    CHECK(collector.getSnapshot(seconds(1), now).total_decisions == 1);
+
+    // Far in the future, nothing recent: every window is empty
+    uint64_t later = BASE_NS + 100 * SEC;
+    MetricsSnapshot idle = collector.getSnapshot(seconds(10), later);
+    CHECK(idle.total_decisions == 0);
+    CHECK(idle.fallback_rate == 0.0f);
+
+    // A new decision there evicts only its own slot
+    collector.observeDecision(decisionAt(later, AILLE::FALLBACK_ACTIVATED));
+    MetricsSnapshot recent = collector.getSnapshot(seconds(10), later);
+    CHECK(recent.total_decisions == 1);
+    CHECK(recent.fallback_activations == 1);
+    // Lifetime counters never expire
+    CHECK(collector.getSnapshot().total_decisions == 57);
+}
+
+AILLE_TEST(late_decisions_land_in_their_own_bucket_or_are_dropped) {
+    MetricsCollector collector(tenSeconds());
+    uint64_t now = BASE_NS + 20 * SEC;
+    collector.observeDecision(decisionAt(now, AILLE::DECISION_VALID));
+    // Three seconds late: still inside the horizon
+    collector.observeDecision(decisionAt(now - 3 * SEC, AILLE::FALLBACK_ACTIVATED));
+    // Older than the horizon: counted for lifetime only
+    collector.observeDecision(decisionAt(now - 30 * SEC, AILLE::FALLBACK_ACTIVATED));
+
+    CHECK(collector.getSnapshot(seconds(1), now).total_decisions == 1);
+    MetricsSnapshot w = collector.getSnapshot(seconds(5), now);
+    CHECK(w.total_decisions == 2);
+    CHECK(w.fallback_activations == 1);
+    CHECK(collector.getSnapshot(seconds(10), now).total_decisions == 2);
+    CHECK(collector.getSnapshot().total_decisions == 3);
+}
+
+AILLE_TEST(window_statistics_and_truncation) {
+    MetricsCollector collector(tenSeconds());
+    collector.observeDecision(decisionAt(BASE_NS, AILLE::DECISION_VALID, 0.2f));
+    collector.observeDecision(decisionAt(BASE_NS + SEC, AILLE::DECISION_VALID, 0.6f));
+    collector.observeDecision(decisionAt(BASE_NS + SEC, AILLE::DECISION_VALID, 1.0f));
+
+    uint64_t now = BASE_NS + SEC;
+    MetricsSnapshot w = collector.getSnapshot(seconds(2), now);
+    CHECK_NEAR(w.average_confidence, 0.6, 1e-6);
+    CHECK(w.min_confidence == 0.2f);
+    CHECK(w.max_confidence == 1.0f);
+    CHECK_NEAR(w.stddev_confidence, std::sqrt(0.32 / 3.0), 1e-6);
+
+    // Longer than the horizon: truncated to it
+    MetricsSnapshot longer = collector.getSnapshot(std::chrono::hours(1), now);
+    CHECK(longer.window_ns == 10 * SEC);
+    CHECK(longer.total_decisions == 3);
+
+    // Invalid decisions are filed under the latest bucket
+    collector.observeDecision(decisionAt(0, AILLE::DECISION_VALID));
+    CHECK(collector.getSnapshot(seconds(1), now).invalid_inputs == 1);
+}
+
+AILLE_TEST(disabled_windows_report_nothing) {
+    MetricsCollector collector;
+    collector.observeDecision(decisionAt(BASE_NS, AILLE::DECISION_VALID));
+    CHECK(collector.getRollingHorizonNs() == 0);
+    MetricsSnapshot w = collector.getSnapshot(seconds(60), BASE_NS);
+    CHECK(w.window_ns == 0);
+    CHECK(w.total_decisions == 0);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
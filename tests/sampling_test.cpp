@@ -0,0 +1,153 @@
+/*
+ * AILLE Sampled Observation Tests
+ *
+ * MetricsConfig::sample_every > 1 (rate < 1): exact counters next to sampled
+ * distributions, Horvitz-Thompson scale-up of the confidence and
+ * final_value counts/sums against the true totals, deterministic and
+ * random (geometric gap) sampling, and error bounds.
+ */
+
+#include <cmath>
+#include <random>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::MetricsConfig;
+using AILLE::MetricsSnapshot;
+
+AILLE::Decision decision(AILLE::DecisionStatus status, float confidence, float final_value) {
+    AILLE::Decision d;
+    d.status = status;
+    d.confidence = confidence;
+    d.final_value = final_value;
+    d.timestamp_ns = 1000000000ULL;
+    return d;
+}
+
+MetricsConfig sampledEvery(uint32_t n, bool random) {
+    MetricsConfig cfg;
+    cfg.sample_every = n;
+    cfg.random_sampling = random;
+    return cfg;
+}
+
+// Every 4th decision falls back; confidence cycles with a period coprime
+// to the sampling interval so every-Nth sampling sees the whole cycle
+struct Stream {
+    uint64_t fallbacks = 0;
+    double confidence_sum = 0.0;
+    double final_value_sum = 0.0;
+
+    void feed(MetricsCollector& collector, int n) {
+        for (int i = 0; i < n; ++i) {
+            AILLE::DecisionStatus status =
+                i % 4 == 0 ? AILLE::FALLBACK_ACTIVATED : AILLE::DECISION_VALID;
+            float conf = 0.1f + 0.8f * static_cast<float>((i * 7) % 13) / 12.0f;
+            float value = 1.0f + static_cast<float>(i % 11);
+            if (status == AILLE::FALLBACK_ACTIVATED) ++fallbacks;
+            confidence_sum += conf;
+            final_value_sum += value;
+            collector.observeDecision(decision(status, conf, value));
+        }
+    }
+};
+
+AILLE_TEST(deterministic_sampling_scales_to_true_totals) {
+    MetricsCollector collector(sampledEvery(10, false));
+    Stream stream;
+    stream.feed(collector, 10000);
+    MetricsSnapshot s = collector.getSnapshot();
+
+    // Counters are exact
+    CHECK(s.total_decisions == 10000);
+    CHECK(s.fallback_activations == stream.fallbacks);
+    CHECK_NEAR(s.fallback_rate, 0.25, 1e-6);
+
+    // Every 10th decision, starting with the first
+    CHECK(s.sampled_decisions == 1000);
+    CHECK_NEAR(s.sampling_rate, 0.1, 1e-6);
+
+    // Sampled distributions are scaled back up to the population
+    CHECK(s.confidence_percentiles.count == 10000);
+    CHECK(s.final_value_percentiles.count == 10000);
+    CHECK_NEAR(s.confidence_percentiles.sum / stream.confidence_sum, 1.0, 0.01);
+    CHECK_NEAR(s.final_value_percentiles.sum / stream.final_value_sum, 1.0, 0.01);
+
+    CHECK(s.average_confidence_error > 0.0f);
+    CHECK(s.confidence_rank_error > 0.0f);
+    CHECK_NEAR(s.average_confidence, stream.confidence_sum / 10000.0,
+               s.average_confidence_error);
+}
+
+AILLE_TEST(random_sampling_scales_to_true_totals) {
+    MetricsConfig cfg = sampledEvery(10, true);
+    cfg.confidence_window = 0;   // lifetime mean, comparable to the stream's
+    MetricsCollector collector(cfg);
+    std::mt19937 rng(65);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    const int n = 100000;
+    double confidence_sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        float conf = unit(rng);
+        confidence_sum += conf;
+        collector.observeDecision(decision(AILLE::DECISION_VALID, conf, 2.0f));
+    }
+    MetricsSnapshot s = collector.getSnapshot();
+
+    CHECK(s.total_decisions == n);
+    // Binomial(n, 0.1): sd ~95, so 1000 is over ten sigma
+    CHECK(s.sampled_decisions > 9000 && s.sampled_decisions < 11000);
+    CHECK_NEAR(s.sampling_rate, static_cast<double>(s.sampled_decisions) / n, 1e-6);
+
+    // Scaling uses the realized rate, so counts match the population
+    // exactly (up to rounding) and sums to within sampling error
+    CHECK_NEAR(static_cast<double>(s.confidence_percentiles.count), n, 1.0);
+    CHECK_NEAR(s.final_value_percentiles.sum, 2.0 * n, 1e-6 * n);
+    CHECK_NEAR(s.confidence_percentiles.sum / confidence_sum, 1.0, 0.02);
+    CHECK_NEAR(s.average_confidence, confidence_sum / n, 0.01);
+    CHECK(s.confidence_rank_error > 0.0f && s.confidence_rank_error < 0.02f);
+}
+
+AILLE_TEST(random_sampling_is_reproducible_per_seed) {
+    auto sampledCount = [](uint64_t seed) {
+        MetricsConfig cfg = sampledEvery(7, true);
+        cfg.sampling_seed = seed;
+        MetricsCollector collector(cfg);
+        for (int i = 0; i < 5000; ++i) {
+            collector.observeDecision(decision(AILLE::DECISION_VALID, 0.5f, 1.0f));
+        }
+        return collector.getSnapshot().sampled_decisions;
+    };
+    CHECK(sampledCount(1) == sampledCount(1));
+    CHECK(sampledCount(1) != sampledCount(2));
+}
+
+AILLE_TEST(unsampled_collector_reports_no_error) {
+    MetricsCollector collector;
+    Stream stream;
+    stream.feed(collector, 500);
+    MetricsSnapshot s = collector.getSnapshot();
+    CHECK(s.sampling_rate == 1.0f);
+    CHECK(s.sampled_decisions == 500);
+    CHECK(s.confidence_percentiles.count == 500);
+    CHECK(s.average_confidence_error == 0.0f);
+    CHECK(s.confidence_rank_error == 0.0f);
+
+    // reset() restarts the countdown: the first decision is sampled again
+    MetricsCollector sampled(sampledEvery(10, false));
+    stream.feed(sampled, 15);
+    CHECK(sampled.getSnapshot().sampled_decisions == 2);
+    sampled.reset();
+    stream.feed(sampled, 1);
+    CHECK(sampled.getSnapshot().sampled_decisions == 1);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
@@ -0,0 +1,79 @@
+/*
+ * AILLE Tests - Minimal Harness
+ *
+ * Dependency-free checks shared by the programs in tests/. Each program
+ * registers cases with AILLE_TEST, runs them from main() through
+ * runAllTests(), prints one line per case and exits non-zero if any check
+ * failed. `make check` builds and runs every *_test.cpp in tests/.
+ *
+ *   AILLE_TEST(histogram_round_trip) {
+ *       CHECK(decoded.isCompatible(original));
+ *       CHECK_NEAR(decoded.percentile(99.0), 990.0, 10.0);
+ *   }
+ */
+
+#ifndef AILLE_TEST_HARNESS_HPP
+#define AILLE_TEST_HARNESS_HPP
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace AILLE {
+namespace test {
+
+struct TestCase {
+    const char* name;
+    void (*body)();
+};
+
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& failureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, void (*body)()) { registry().push_back({name, body}); }
+};
+
+inline void fail(const char* file, int line, const char* expr) {
+    std::printf("    %s:%d: check failed: %s\n", file, line, expr);
+    ++failureCount();
+}
+
+// Runs every registered case; returns the process exit code
+inline int runAllTests() {
+    int failed_cases = 0;
+    for (const TestCase& t : registry()) {
+        int before = failureCount();
+        t.body();
+        bool ok = failureCount() == before;
+        if (!ok) ++failed_cases;
+        std::printf("%s %s\n", ok ? "PASS" : "FAIL", t.name);
+    }
+    std::printf("%zu cases, %d failed\n", registry().size(), failed_cases);
+    return failed_cases == 0 ? 0 : 1;
+}
+
+} // namespace test
+} // namespace AILLE
+
+#define AILLE_TEST(name)                                                       \
+    static void name();                                                        \
+    static ::AILLE::test::Registrar name##_registrar(#name, &name);            \
+    static void name()
+
+#define CHECK(expr)                                                            \
+    do {                                                                       \
+        if (!(expr)) ::AILLE::test::fail(__FILE__, __LINE__, #expr);           \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                \
+    CHECK(std::fabs(static_cast<double>(actual) - static_cast<double>(expected)) <= (tolerance))
+
+#endif // AILLE_TEST_HARNESS_HPP
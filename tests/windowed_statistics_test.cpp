@@ -0,0 +1,136 @@
+/*
+ * AILLE Windowed Confidence Statistics Tests
+ *
+ * The O(1) running sums and monotonic-deque min/max against a direct
+ * pass over the last confidence_window samples: eviction after the
+ * window wraps, monotone runs that stress the deques, and lifetime
+ * statistics with a zero-sized window.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "aille.hpp"
+#include "extensions/aille_metrics.hpp"
+#include "tests/test_harness.hpp"
+
+namespace {
+
+using AILLE::MetricsCollector;
+using AILLE::MetricsConfig;
+using AILLE::MetricsSnapshot;
+
+AILLE::Decision decisionWith(float confidence) {
+    AILLE::Decision d;
+    d.status = AILLE::DECISION_VALID;
+    d.confidence = confidence;
+    d.timestamp_ns = 1000000000ULL;
+    return d;
+}
+
+// Statistics of the last `window` values (all of them when window is 0)
+void checkAgainstDirect(const MetricsSnapshot& s, const std::vector<float>& values,
+                        size_t window) {
+    size_t n = window ? std::min(window, values.size()) : values.size();
+    auto first = values.end() - static_cast<std::ptrdiff_t>(n);
+    double sum = 0.0, sum_sq = 0.0;
+    float lo = *first, hi = *first;
+    for (auto it = first; it != values.end(); ++it) {
+        sum += *it;
+        sum_sq += static_cast<double>(*it) * *it;
+        lo = std::min(lo, *it);
+        hi = std::max(hi, *it);
+    }
+    double mean = sum / n;
+    CHECK_NEAR(s.average_confidence, mean, 1e-5);
+    CHECK(s.min_confidence == lo);
+    CHECK(s.max_confidence == hi);
+    CHECK_NEAR(s.stddev_confidence, std::sqrt(std::max(sum_sq / n - mean * mean, 0.0)), 1e-4);
+}
+
+AILLE_TEST(random_stream_matches_direct_window) {
+    MetricsConfig cfg;
+    cfg.confidence_window = 50;
+    MetricsCollector collector(cfg);
+    std::mt19937 rng(51);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<float> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(unit(rng));
+        collector.observeDecision(decisionWith(values.back()));
+        // Before, at and well past the first wrap
+        if (i < 60 || i % 37 == 0) checkAgainstDirect(collector.getSnapshot(), values, 50);
+    }
+    CHECK(collector.getSampleCount() == 50);
+}
+
+AILLE_TEST(monotone_runs_evict_extremes) {
+    MetricsConfig cfg;
+    cfg.confidence_window = 20;
+    MetricsCollector collector(cfg);
+    std::vector<float> values;
+    auto feed = [&](float v) {
+        values.push_back(v);
+        collector.observeDecision(decisionWith(v));
+        checkAgainstDirect(collector.getSnapshot(), values, 20);
+    };
+
+    // Rising: every new value evicts the whole max deque; the min only
+    // moves when the oldest sample leaves the window
+    for (int i = 0; i < 60; ++i) feed(0.01f * i);
+    // Falling: the mirror image
+    for (int i = 60; i > 0; --i) feed(0.01f * i);
+    // A lone extreme survives exactly one window
+    feed(0.0f);
+    for (int i = 0; i < 19; ++i) feed(0.5f);
+    CHECK(collector.getSnapshot().min_confidence == 0.0f);
+    feed(0.5f);
+    CHECK(collector.getSnapshot().min_confidence == 0.5f);
+    // Repeated equal values keep the window's min and max equal
+    CHECK(collector.getSnapshot().max_confidence == 0.5f);
+    CHECK(collector.getSnapshot().stddev_confidence == 0.0f);
+}
+
+AILLE_TEST(zero_window_keeps_lifetime_statistics) {
+    MetricsConfig cfg;
+    cfg.confidence_window = 0;
+    MetricsCollector collector(cfg);
+    std::mt19937 rng(52);
+    std::uniform_real_distribution<float> unit(0.2f, 0.9f);
+
+    std::vector<float> values;
+    for (int i = 0; i < 20000; ++i) {
+        values.push_back(unit(rng));
+        collector.observeDecision(decisionWith(values.back()));
+    }
+    checkAgainstDirect(collector.getSnapshot(), values, 0);
+    // No raw samples are retained
+    CHECK(collector.getSampleCount() == 0);
+}
+
+AILLE_TEST(invalid_decisions_do_not_enter_the_window) {
+    MetricsConfig cfg;
+    cfg.confidence_window = 4;
+    MetricsCollector collector(cfg);
+    std::vector<float> values = {0.2f, 0.4f, 0.6f};
+    for (float v : values) collector.observeDecision(decisionWith(v));
+    collector.observeDecision(decisionWith(NAN));
+    collector.observeDecision(decisionWith(1.5f));
+
+    MetricsSnapshot s = collector.getSnapshot();
+    CHECK(s.invalid_inputs == 2);
+    CHECK(collector.getSampleCount() == 3);
+    checkAgainstDirect(s, values, 4);
+
+    collector.reset();
+    s = collector.getSnapshot();
+    CHECK(collector.getSampleCount() == 0);
+    CHECK(s.average_confidence == 0.0f && s.min_confidence == 0.0f && s.max_confidence == 0.0f);
+}
+
+} // namespace
+
+int main() { return AILLE::test::runAllTests(); }
@@ -0,0 +1,491 @@
+/*
+ * aille-bench-compare - Benchmark Regression Check
+ *
+ * Compares `aille-bench --json` result files benchmark by benchmark. Each
+ * side is one or more independent runs; with two or more runs per side
+ * every run contributes its mean ns/op as one sample, so the spread
+ * between runs (frequency scaling, noisy neighbours, page cache state)
+ * is inside the interval rather than left to the threshold. The
+ * difference in means gets a Welch confidence interval (unequal
+ * variances, Welch-Satterthwaite degrees of freedom). A benchmark is
+ * flagged when the interval excludes zero and the point change is at
+ * least the threshold:
+ *
+ *   REGRESSION   significantly slower by >= threshold
+ *   improved     significantly faster by >= threshold
+ *   ~            no significant change (or below threshold)
+ *
+ * With a single file per side the samples are that run's repetitions,
+ * and the interval only covers variation within the run; drift between
+ * the two runs then goes unmeasured, and a quiet-looking benchmark can
+ * show a "significant" change on an unchanged tree. Differing environment
+ * fingerprints (CPU model, compiler, build flags) are reported, since
+ * such results are not like-for-like.
+ *
+ * Exit status: 0 no regressions, 1 at least one regression, 2 bad input.
+ *
+ * Usage: aille-bench-compare BASELINE.json CURRENT.json
+ *        aille-bench-compare BASE1.json BASE2.json ... -- CUR1.json CUR2.json ...
+ *                            [--confidence 0.95] [--threshold-pct 5]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ============================================================================
+// MINIMAL JSON READER
+// ============================================================================
+
+struct JsonValue {
+    enum Type { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+    Type type = NUL;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* get(const std::string& key) const {
+        for (const auto& kv : object) {
+            if (kv.first == key) return &kv.second;
+        }
+        return nullptr;
+    }
+    std::string str(const std::string& key) const {
+        const JsonValue* v = get(key);
+        return (v && v->type == STRING) ? v->string : std::string();
+    }
+};
+
+class JsonParser {
+private:
+    const std::string& text;
+    size_t pos = 0;
+
+public:
+    explicit JsonParser(const std::string& t) : text(t) {}
+
+    bool parse(JsonValue& out) {
+        if (!value(out)) return false;
+        skipSpace();
+        return pos == text.size();
+    }
+
+private:
+    void skipSpace() {
+        while (pos < text.size() && std::strchr(" \t\r\n", text[pos])) ++pos;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if (text.compare(pos, n, word) != 0) return false;
+        pos += n;
+        return true;
+    }
+
+    bool value(JsonValue& out) {
+        skipSpace();
+        if (pos >= text.size()) return false;
+        char c = text[pos];
+        if (c == '{') return objectValue(out);
+        if (c == '[') return arrayValue(out);
+        if (c == '"') {
+            out.type = JsonValue::STRING;
+            return stringValue(out.string);
+        }
+        if (literal("true")) {
+            out.type = JsonValue::BOOL;
+            out.boolean = true;
+            return true;
+        }
+        if (literal("false")) {
+            out.type = JsonValue::BOOL;
+            return true;
+        }
+        if (literal("null")) return true;
+
+        char* end = nullptr;
+        out.number = std::strtod(text.c_str() + pos, &end);
+        if (end == text.c_str() + pos) return false;
+        out.type = JsonValue::NUMBER;
+        pos = static_cast<size_t>(end - text.c_str());
+        return true;
+    }
+
+    bool stringValue(std::string& out) {
+        ++pos;  // opening quote
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\') {
+                if (++pos >= text.size()) return false;
+                char e = text[pos];
+                out += (e == 'n') ? '\n' : (e == 't') ? '\t' : e;
+            } else {
+                out += text[pos];
+            }
+            ++pos;
+        }
+        if (pos >= text.size()) return false;
+        ++pos;  // closing quote
+        return true;
+    }
+
+    bool arrayValue(JsonValue& out) {
+        out.type = JsonValue::ARRAY;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == ']') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            out.array.emplace_back();
+            if (!value(out.array.back())) return false;
+            skipSpace();
+            if (pos >= text.size()) return false;
+            if (text[pos++] == ']') return true;
+            if (text[pos - 1] != ',') return false;
+        }
+    }
+
+    bool objectValue(JsonValue& out) {
+        out.type = JsonValue::OBJECT;
+        ++pos;
+        skipSpace();
+        if (pos < text.size() && text[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipSpace();
+            std::string key;
+            if (pos >= text.size() || text[pos] != '"' || !stringValue(key)) return false;
+            skipSpace();
+            if (pos >= text.size() || text[pos++] != ':') return false;
+            out.object.emplace_back(key, JsonValue());
+            if (!value(out.object.back().second)) return false;
+            skipSpace();
+            if (pos >= text.size()) return false;
+            if (text[pos++] == '}') return true;
+            if (text[pos - 1] != ',') return false;
+        }
+    }
+};
+
+// ============================================================================
+// RESULT FILES
+// ============================================================================
+
+struct ResultFile {
+    std::string path;
+    std::string cpu_model;
+    std::string compiler;
+    std::string flags;
+    std::string timestamp;
+    std::map<std::string, std::vector<double>> samples;  // name -> ns/op per repetition
+    std::vector<std::string> order;                      // file order, for output
+};
+
+bool loadResults(const std::string& path, ResultFile& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream buf;
+    buf << in.rdbuf();
+    std::string text = buf.str();
+
+    JsonValue root;
+    JsonParser parser(text);
+    if (!parser.parse(root) || root.type != JsonValue::OBJECT ||
+        root.str("format") != "aille-bench-v1") {
+        std::fprintf(stderr, "%s: not an aille-bench-v1 result file\n", path.c_str());
+        return false;
+    }
+
+    out.path = path;
+    if (const JsonValue* env = root.get("environment")) {
+        out.cpu_model = env->str("cpu_model");
+        out.compiler = env->str("compiler");
+        out.flags = env->str("flags");
+        out.timestamp = env->str("timestamp");
+    }
+    const JsonValue* list = root.get("benchmarks");
+    if (!list || list->type != JsonValue::ARRAY) return false;
+    for (const JsonValue& b : list->array) {
+        const JsonValue* s = b.get("samples_ns");
+        std::string name = b.str("name");
+        if (name.empty() || !s || s->type != JsonValue::ARRAY) continue;
+        // A body the optimizer removed has no timing worth comparing
+        const JsonValue* removed = b.get("optimized_away");
+        if (removed && removed->type == JsonValue::BOOL && removed->boolean) {
+            std::fprintf(stderr, "%s: skipping %s (optimized away)\n", path.c_str(),
+                         name.c_str());
+            continue;
+        }
+        std::vector<double>& v = out.samples[name];
+        for (const JsonValue& x : s->array) {
+            if (x.type == JsonValue::NUMBER) v.push_back(x.number);
+        }
+        out.order.push_back(name);
+    }
+    return true;
+}
+
+// ============================================================================
+// WELCH CONFIDENCE INTERVAL
+// ============================================================================
+
+// Continued fraction for the regularized incomplete beta (modified Lentz)
+double betaContinuedFraction(double a, double b, double x) {
+    const double tiny = 1e-300;
+    double c = 1.0;
+    double d = 1.0 - (a + b) * x / (a + 1.0);
+    if (std::fabs(d) < tiny) d = tiny;
+    d = 1.0 / d;
+    double h = d;
+    for (int m = 1; m <= 300; ++m) {
+        double m2 = 2.0 * m;
+        double num = m * (b - m) * x / ((a + m2 - 1.0) * (a + m2));
+        d = 1.0 + num * d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + num / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        h *= d * c;
+
+        num = -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1.0));
+        d = 1.0 + num * d;
+        if (std::fabs(d) < tiny) d = tiny;
+        c = 1.0 + num / c;
+        if (std::fabs(c) < tiny) c = tiny;
+        d = 1.0 / d;
+        double step = d * c;
+        h *= step;
+        if (std::fabs(step - 1.0) < 1e-12) break;
+    }
+    return h;
+}
+
+double incompleteBeta(double a, double b, double x) {
+    if (x <= 0.0) return 0.0;
+    if (x >= 1.0) return 1.0;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) return front * betaContinuedFraction(a, b, x) / a;
+    return 1.0 - front * betaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+// P(T <= t) for Student's t with df degrees of freedom, t >= 0
+double studentTCdf(double t, double df) {
+    return 1.0 - 0.5 * incompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+}
+
+// Two-sided critical value: P(|T| <= t) = confidence
+double studentTCritical(double confidence, double df) {
+    double target = 0.5 + confidence / 2.0;
+    double lo = 0.0, hi = 1000.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = 0.5 * (lo + hi);
+        if (studentTCdf(mid, df) < target) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+struct Comparison {
+    double base_mean = 0.0;
+    double cur_mean = 0.0;
+    double change = 0.0;               // relative to baseline mean
+    double ci_low = 0.0;               // relative, lower bound
+    double ci_high = 0.0;              // relative, upper bound
+    bool significant = false;
+};
+
+void meanVariance(const std::vector<double>& v, double& mean, double& var) {
+    mean = 0.0;
+    for (double x : v) mean += x;
+    mean /= static_cast<double>(v.size());
+    var = 0.0;
+    for (double x : v) var += (x - mean) * (x - mean);
+    var /= static_cast<double>(v.size() - 1);
+}
+
+Comparison welch(const std::vector<double>& base, const std::vector<double>& cur,
+                 double confidence) {
+    Comparison c;
+    double vb, vc;
+    meanVariance(base, c.base_mean, vb);
+    meanVariance(cur, c.cur_mean, vc);
+    double nb = static_cast<double>(base.size());
+    double nc = static_cast<double>(cur.size());
+
+    double se2 = vb / nb + vc / nc;
+    double df = nb + nc - 2.0;
+    if (se2 > 0.0) {
+        double denom = (vb / nb) * (vb / nb) / (nb - 1.0) + (vc / nc) * (vc / nc) / (nc - 1.0);
+        if (denom > 0.0) df = se2 * se2 / denom;
+    }
+    double half = studentTCritical(confidence, df) * std::sqrt(se2);
+    double diff = c.cur_mean - c.base_mean;
+
+    double scale = c.base_mean > 0.0 ? c.base_mean : 1.0;
+    c.change = diff / scale;
+    c.ci_low = (diff - half) / scale;
+    c.ci_high = (diff + half) / scale;
+    c.significant = c.ci_low > 0.0 || c.ci_high < 0.0;
+    return c;
+}
+
+void printEnvironment(const char* role, const std::vector<ResultFile>& runs) {
+    const ResultFile& f = runs.front();
+    std::printf("%-9s %s  (%s)", role, f.path.c_str(), f.timestamp.c_str());
+    if (runs.size() > 1) std::printf(" + %zu more run(s)", runs.size() - 1);
+    std::printf("\n          cpu: %s\n          compiler: %s\n          flags: %s\n",
+                f.cpu_model.c_str(), f.compiler.c_str(), f.flags.c_str());
+}
+
+bool sameEnvironment(const ResultFile& a, const ResultFile& b) {
+    return a.cpu_model == b.cpu_model && a.compiler == b.compiler && a.flags == b.flags;
+}
+
+// Samples for one benchmark on one side: each run's mean when there are
+// several runs, otherwise the single run's repetitions
+std::vector<double> sideSamples(const std::vector<ResultFile>& runs, const std::string& name) {
+    std::vector<double> out;
+    if (runs.size() == 1) {
+        auto it = runs.front().samples.find(name);
+        if (it != runs.front().samples.end()) out = it->second;
+        return out;
+    }
+    for (const ResultFile& run : runs) {
+        auto it = run.samples.find(name);
+        if (it == run.samples.end() || it->second.empty()) continue;
+        double sum = 0.0;
+        for (double x : it->second) sum += x;
+        out.push_back(sum / static_cast<double>(it->second.size()));
+    }
+    return out;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> base_files, cur_files;
+    bool separator = false;
+    bool bad_flag = false;
+    double confidence = 0.95;
+    double threshold = 0.05;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--confidence") == 0 && i + 1 < argc) {
+            confidence = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threshold-pct") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]) / 100.0;
+        } else if (std::strcmp(argv[i], "--") == 0 && !separator) {
+            separator = true;
+        } else if (argv[i][0] != '-') {
+            (separator ? cur_files : base_files).push_back(argv[i]);
+        } else {
+            bad_flag = true;
+        }
+    }
+    // Without "--", the two positional files are baseline and current
+    if (!separator && base_files.size() == 2) {
+        cur_files.push_back(base_files.back());
+        base_files.pop_back();
+    }
+    if (bad_flag || base_files.empty() || cur_files.empty() ||
+        !(confidence > 0.0 && confidence < 1.0) || threshold < 0.0) {
+        std::fprintf(stderr,
+                     "usage: %s BASELINE.json CURRENT.json [--confidence 0.95] "
+                     "[--threshold-pct 5]\n"
+                     "       %s BASE.json... -- CURRENT.json... [options]\n",
+                     argv[0], argv[0]);
+        return 2;
+    }
+
+    std::vector<ResultFile> base(base_files.size()), cur(cur_files.size());
+    for (size_t i = 0; i < base_files.size(); ++i) {
+        if (!loadResults(base_files[i], base[i])) return 2;
+    }
+    for (size_t i = 0; i < cur_files.size(); ++i) {
+        if (!loadResults(cur_files[i], cur[i])) return 2;
+    }
+    const bool per_run = base.size() >= 2 && cur.size() >= 2;
+
+    printEnvironment("baseline", base);
+    printEnvironment("current", cur);
+    bool same = true;
+    for (const ResultFile& f : base) same = same && sameEnvironment(f, base.front());
+    for (const ResultFile& f : cur) same = same && sameEnvironment(f, base.front());
+    if (!same) {
+        std::printf("\nWARNING: environment fingerprints differ; changes may not come "
+                    "from the code\n");
+    }
+    if (per_run) {
+        std::printf("\nSamples are per-run means (%zu baseline, %zu current runs)\n",
+                    base.size(), cur.size());
+    } else {
+        std::printf("\nNOTE: one run per side; the interval covers repetition noise only, "
+                    "not drift between runs\n");
+    }
+
+    std::printf("\n%-46s %11s %11s %9s %22s  %s\n", "benchmark", "base ns", "current ns",
+                "change", "CI", "verdict");
+    std::printf("%s\n", std::string(115, '-').c_str());
+
+    int regressions = 0, improvements = 0, unchanged = 0, skipped = 0;
+    for (const std::string& name : cur.front().order) {
+        std::vector<double> b = sideSamples(base, name);
+        std::vector<double> c = sideSamples(cur, name);
+        if (b.size() < 2 || c.size() < 2) {
+            ++skipped;
+            continue;
+        }
+        Comparison r = welch(b, c, confidence);
+
+        const char* verdict = "~";
+        if (r.significant && r.change >= threshold) {
+            verdict = "REGRESSION";
+            ++regressions;
+        } else if (r.significant && r.change <= -threshold) {
+            verdict = "improved";
+            ++improvements;
+        } else {
+            ++unchanged;
+        }
+        char ci[48];
+        std::snprintf(ci, sizeof(ci), "[%+.1f%%, %+.1f%%]", 100.0 * r.ci_low, 100.0 * r.ci_high);
+        std::printf("%-46s %11.1f %11.1f %+8.1f%% %22s  %s\n", name.c_str(), r.base_mean,
+                    r.cur_mean, 100.0 * r.change, ci, verdict);
+    }
+
+    std::printf("\n%d regression(s), %d improvement(s), %d unchanged at %.0f%% confidence, "
+                "threshold %.1f%%",
+                regressions, improvements, unchanged, 100.0 * confidence, 100.0 * threshold);
+    if (skipped) std::printf("; %d not comparable (missing or < 2 samples)", skipped);
+    std::printf("\n");
+    return regressions > 0 ? 1 : 0;
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make bench-compare                          # first run saves the baseline
+ * make bench-compare                          # later runs compare against it
+ * ./aille-bench-compare old.json new.json --confidence 0.99 --threshold-pct 5
+ * ./aille-bench-compare base_*.json -- cur_*.json
+ */
@@ -0,0 +1,193 @@
+/*
+ * aille-top - Live AILLE Metrics Viewer
+ *
+ * Maps the shared-memory page published by ShmMetricsPublisher and
+ * redraws counters, rates and distributions in the terminal. Reads never
+ * call into the decision process; each refresh is one seqlock copy.
+ *
+ * Usage: aille-top [--name /aille_metrics] [--interval-us 500] [--once]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "aille.hpp"
+#include "extensions/aille_shm_metrics.hpp"
+
+namespace {
+
+void printPercentiles(const char* label, const AILLE::ShmPercentiles& p, double scale,
+                      const char* unit) {
+    if (p.count == 0) {
+        std::printf("  %-12s (no samples)\n", label);
+        return;
+    }
+    std::printf("  %-12s p50 %10.4f  p90 %10.4f  p99 %10.4f  p99.9 %10.4f %s\n",
+                label, p.p50 * scale, p.p90 * scale, p.p99 * scale, p.p999 * scale, unit);
+}
+
+void printModelsAgreed(const AILLE::ShmMetricsPayload& p) {
+    uint64_t peak = 0;
+    for (uint64_t b : p.models_agreed) peak = std::max(peak, b);
+    if (peak == 0) return;
+
+    std::printf("\nModels Agreed:\n");
+    for (int n = 0; n <= AILLE::SHM_MODELS_BUCKETS; ++n) {
+        if (p.models_agreed[n] == 0) continue;
+        int bar = static_cast<int>(40.0 * p.models_agreed[n] / peak);
+        std::printf("  %3d | %-40.*s %llu\n", n, bar,
+                    "########################################",
+                    static_cast<unsigned long long>(p.models_agreed[n]));
+    }
+    if (p.models_agreed_overflow > 0) {
+        std::printf("  >%2d | %llu\n", AILLE::SHM_MODELS_BUCKETS,
+                    static_cast<unsigned long long>(p.models_agreed_overflow));
+    }
+}
+
+void printRegimes(const AILLE::ShmFallbackRegimes& r, uint64_t fallback_activations) {
+    if (r.current_streak == 0) return;
+    uint64_t total_ns = r.time_in_fallback_ns + r.time_in_normal_ns;
+    std::printf("\nRegimes:    %s for %llu decisions (%.1f ms)  longest fallback %llu  normal %llu\n",
+                r.in_fallback ? "FALLBACK" : "normal",
+                static_cast<unsigned long long>(r.current_streak), r.current_streak_ns / 1e6,
+                static_cast<unsigned long long>(r.longest_fallback_streak),
+                static_cast<unsigned long long>(r.longest_normal_streak));
+    std::printf("            %llu episodes (mean %.1f decisions)  %.2f%% of time in fallback\n",
+                static_cast<unsigned long long>(r.fallback_episodes),
+                r.fallback_episodes ? static_cast<double>(fallback_activations) / r.fallback_episodes
+                                    : 0.0,
+                total_ns ? 100.0 * r.time_in_fallback_ns / total_ns : 0.0);
+}
+
+// Decisions per second between two payloads carrying different snapshots;
+// 0 across a collector reset or writer restart (counters went backwards)
+double decisionRate(const AILLE::ShmMetricsPayload& latest,
+                    const AILLE::ShmMetricsPayload& prev) {
+    if (prev.publish_count == 0 || latest.publish_count < prev.publish_count ||
+        latest.total_decisions < prev.total_decisions ||
+        latest.publish_timestamp_ns <= prev.publish_timestamp_ns) {
+        return 0.0;
+    }
+    double dt = (latest.publish_timestamp_ns - prev.publish_timestamp_ns) / 1e9;
+    return (latest.total_decisions - prev.total_decisions) / dt;
+}
+
+void draw(const AILLE::ShmMetricsPayload& p, double rate, uint64_t writer_pid, bool clear) {
+    bool stale = AILLE::ShmMetricsReader::isStale(p, std::chrono::seconds(2));
+
+    if (clear) std::printf("\033[H\033[2J");
+    std::printf("aille-top  pid %llu  publish #%llu  snapshot #%llu%s%s\n\n",
+                static_cast<unsigned long long>(writer_pid),
+                static_cast<unsigned long long>(p.publish_count),
+                static_cast<unsigned long long>(p.snapshot_generation),
+                stale ? "  [STALE]" : "",
+                p.snapshot_generation == 0 ? "  [COLLECTOR NOT PUBLISHING]" : "");
+
+    std::printf("Decisions:  %llu total  %llu valid  %.1f/s\n",
+                static_cast<unsigned long long>(p.total_decisions),
+                static_cast<unsigned long long>(p.valid_decisions), rate);
+    std::printf("Fallbacks:  %llu (%.2f%%)   Rejected: %llu confidence, %llu consensus\n",
+                static_cast<unsigned long long>(p.fallback_activations),
+                p.fallback_rate * 100.0,
+                static_cast<unsigned long long>(p.rejected_confidence),
+                static_cast<unsigned long long>(p.rejected_consensus));
+    std::printf("Invalid:    %llu%s\n", static_cast<unsigned long long>(p.invalid_inputs),
+                p.overflow_detected ? "   [COUNTER OVERFLOW]" : "");
+    std::printf("Confidence: avg %.4f  min %.4f  max %.4f  stddev %.4f\n",
+                p.average_confidence, p.min_confidence, p.max_confidence,
+                p.stddev_confidence);
+
+    std::printf("\nDistributions:\n");
+    printPercentiles("confidence", p.confidence, 1.0, "");
+    printPercentiles("final_value", p.final_value, 1.0, "");
+    printPercentiles("latency", p.latency_ns, 1e-3, "us");
+    for (int i = 0; i < AILLE::DECISION_STATUS_COUNT; ++i) {
+        if (p.latency_ns_by_status[i].count == 0) continue;
+        std::string label =
+            std::string("  ") + AILLE::decisionStatusLabel(static_cast<AILLE::DecisionStatus>(i));
+        printPercentiles(label.c_str(), p.latency_ns_by_status[i], 1e-3, "us");
+    }
+
+    printRegimes(p.fallback_regimes, p.fallback_activations);
+
+    printModelsAgreed(p);
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = AILLE::ShmMetricsConfig().name;
+    long interval_us = 500;
+    bool once = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+            name = argv[++i];
+        } else if (std::strcmp(argv[i], "--interval-us") == 0 && i + 1 < argc) {
+            interval_us = std::max(1L, std::atol(argv[++i]));
+        } else if (std::strcmp(argv[i], "--once") == 0) {
+            once = true;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--name /aille_metrics] [--interval-us N] [--once]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    AILLE::ShmMetricsReader reader;
+    if (!reader.open(name)) {
+        std::fprintf(stderr, "aille-top: cannot open shared memory %s\n", name.c_str());
+        return 1;
+    }
+
+    // Rates span the two latest collector snapshots; heartbeats in between
+    // only refresh the staleness check
+    AILLE::ShmMetricsPayload current{};
+    AILLE::ShmMetricsPayload latest{};
+    AILLE::ShmMetricsPayload previous{};
+    uint64_t shown_publish = 0;
+    auto last_draw = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+
+    while (true) {
+        AILLE::ShmReadStatus status = reader.read(current);
+        if (status == AILLE::SHM_READ_BAD_LAYOUT) {
+            std::fprintf(stderr, "aille-top: incompatible layout in %s (expected v%u)\n",
+                         name.c_str(), AILLE::SHM_LAYOUT_VERSION);
+            return 1;
+        }
+
+        // Sample at interval_us, but redraw the terminal at most ~20 Hz
+        auto now = std::chrono::steady_clock::now();
+        if (status == AILLE::SHM_READ_OK &&
+            current.snapshot_generation != latest.snapshot_generation) {
+            previous = latest;
+            latest = current;
+        }
+        if (status == AILLE::SHM_READ_OK &&
+            (once || now - last_draw >= std::chrono::milliseconds(50))) {
+            if (current.publish_count != shown_publish || once) {
+                draw(current, decisionRate(latest, previous), reader.getWriterPid(), !once);
+                shown_publish = current.publish_count;
+                last_draw = now;
+            }
+        }
+        if (once) return status == AILLE::SHM_READ_OK ? 0 : 1;
+        std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+}
+
+/*
+ * TO COMPILE AND RUN:
+ *
+ * make aille-top
+ * ./aille-top                      # live view, 500 us sampling
+ * ./aille-top --once               # single snapshot, e.g. for watchdog scripts
+ */